@@ -0,0 +1,144 @@
+/*
+ * Copyright 2020  Michail Vourlakos <mvourlakos@gmail.com>
+ *
+ * This file is part of Latte-Dock
+ *
+ * Latte-Dock is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Latte-Dock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "idsallocator.h"
+
+// local
+#include "lattecorona.h"
+
+// KDE
+#include <KConfigGroup>
+
+// Plasma
+#include <Plasma/Applet>
+#include <Plasma/Containment>
+
+#define MAXID 32000
+
+namespace Latte {
+
+IdsAllocator::IdsAllocator(Latte::Corona *corona)
+    : QObject(corona),
+      m_corona(corona)
+{
+    connect(m_corona, &Plasma::Corona::containmentAdded, this, &IdsAllocator::addContainment);
+}
+
+IdsAllocator::~IdsAllocator()
+{
+}
+
+bool IdsAllocator::isUsed(uint id) const
+{
+    return m_usedIds.contains(id);
+}
+
+uint IdsAllocator::allocate(uint &base, QSet<uint> &reserved) const
+{
+    while (base < MAXID) {
+        uint id = base++;
+
+        if (!m_usedIds.contains(id) && !reserved.contains(id)) {
+            reserved << id;
+            return id;
+        }
+    }
+
+    return 0;
+}
+
+void IdsAllocator::addContainment(Plasma::Containment *containment)
+{
+    if (!containment) {
+        return;
+    }
+
+    const uint containmentId = containment->id();
+
+    if (m_containmentApplets.contains(containmentId)) {
+        return;
+    }
+
+    m_containmentApplets[containmentId] = QSet<uint>();
+    m_usedIds[containmentId]++;
+
+    //! applets that are only present in configuration are also considered
+    for (const auto &appletId : containment->config().group("Applets").groupList()) {
+        addApplet(containmentId, appletId.toUInt());
+    }
+
+    for (const auto applet : containment->applets()) {
+        addApplet(containmentId, applet->id());
+    }
+
+    connect(containment, &Plasma::Containment::appletAdded, this, [this, containmentId](Plasma::Applet *applet) {
+        addApplet(containmentId, applet->id());
+    });
+
+    connect(containment, &Plasma::Containment::appletRemoved, this, [this, containmentId](Plasma::Applet *applet) {
+        removeApplet(containmentId, applet->id());
+    });
+
+    connect(containment, &QObject::destroyed, this, [this, containmentId]() {
+        removeContainment(containmentId);
+    });
+}
+
+void IdsAllocator::addApplet(uint containmentId, uint appletId)
+{
+    if (appletId == 0 || m_containmentApplets[containmentId].contains(appletId)) {
+        return;
+    }
+
+    m_containmentApplets[containmentId] << appletId;
+    m_usedIds[appletId]++;
+}
+
+void IdsAllocator::removeApplet(uint containmentId, uint appletId)
+{
+    if (!m_containmentApplets.contains(containmentId) || !m_containmentApplets[containmentId].contains(appletId)) {
+        return;
+    }
+
+    m_containmentApplets[containmentId].remove(appletId);
+
+    if (--m_usedIds[appletId] <= 0) {
+        m_usedIds.remove(appletId);
+    }
+}
+
+void IdsAllocator::removeContainment(uint containmentId)
+{
+    if (!m_containmentApplets.contains(containmentId)) {
+        return;
+    }
+
+    for (const auto appletId : m_containmentApplets.take(containmentId)) {
+        if (--m_usedIds[appletId] <= 0) {
+            m_usedIds.remove(appletId);
+        }
+    }
+
+    if (--m_usedIds[containmentId] <= 0) {
+        m_usedIds.remove(containmentId);
+    }
+}
+
+}
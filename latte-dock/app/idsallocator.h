@@ -0,0 +1,78 @@
+/*
+ * Copyright 2020  Michail Vourlakos <mvourlakos@gmail.com>
+ *
+ * This file is part of Latte-Dock
+ *
+ * Latte-Dock is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Latte-Dock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef IDSALLOCATOR_H
+#define IDSALLOCATOR_H
+
+// Qt
+#include <QHash>
+#include <QObject>
+#include <QSet>
+
+namespace Plasma {
+class Applet;
+class Containment;
+}
+
+namespace Latte {
+class Corona;
+}
+
+namespace Latte {
+
+//! Keeps the ids that are used from Corona containments and their applets up to date
+//! based on Corona and containments signals. This way new unique ids can be allocated
+//! without collecting all ids from containments and their configuration each time.
+class IdsAllocator : public QObject
+{
+    Q_OBJECT
+
+public:
+    IdsAllocator(Latte::Corona *corona);
+    ~IdsAllocator() override;
+
+    bool isUsed(uint id) const;
+
+    //! returns the first id from base that is neither used nor reserved and
+    //! reserves it, base is updated in order to continue from that id afterwards
+    uint allocate(uint &base, QSet<uint> &reserved) const;
+
+private slots:
+    void addContainment(Plasma::Containment *containment);
+
+private:
+    void addApplet(uint containmentId, uint appletId);
+    void removeApplet(uint containmentId, uint appletId);
+    void removeContainment(uint containmentId);
+
+private:
+    //! id and the number of its users, ids should be unique but
+    //! broken layouts can contain duplicates
+    QHash<uint, int> m_usedIds;
+
+    //! containment id and the applets ids that it registered
+    QHash<uint, QSet<uint>> m_containmentApplets;
+
+    Latte::Corona *m_corona{nullptr};
+};
+
+}
+
+#endif
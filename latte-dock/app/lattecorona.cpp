@@ -24,8 +24,10 @@
 #include <coretypes.h>
 #include "alternativeshelper.h"
 #include "apptypes.h"
+#include "idsallocator.h"
 #include "lattedockadaptor.h"
 #include "screenpool.h"
+#include "screenregions.h"
 #include "declarativeimports/interfaces.h"
 #include "indicator/factory.h"
 #include "layout/centrallayout.h"
@@ -98,7 +100,9 @@ Corona::Corona(bool defaultLayoutOnStartup, QString layoutNameOnStartUp, int use
       m_userSetMemoryUsage(userSetMemoryUsage),
       m_layoutNameOnStartUp(layoutNameOnStartUp),
       m_activitiesConsumer(new KActivities::Consumer(this)),
+      m_idsAllocator(new IdsAllocator(this)),
       m_screenPool(new ScreenPool(KSharedConfig::openConfig(), this)),
+      m_screenRegions(new ScreenRegions(this)),
       m_indicatorFactory(new Indicator::Factory(this)),
       m_universalSettings(new UniversalSettings(KSharedConfig::openConfig(), this)),
       m_globalShortcuts(new GlobalShortcuts(this)),
@@ -188,6 +192,8 @@ Corona::~Corona()
     m_layoutsManager->unload();
 
     m_plasmaGeometries->deleteLater();
+    m_screenRegions->deleteLater();
+    m_idsAllocator->deleteLater();
     m_wm->deleteLater();
     m_dialogShadows->deleteLater();
     m_globalShortcuts->deleteLater();
@@ -421,6 +427,11 @@ GlobalShortcuts *Corona::globalShortcuts() const
     return m_globalShortcuts;
 }
 
+IdsAllocator *Corona::idsAllocator() const
+{
+    return m_idsAllocator;
+}
+
 ScreenPool *Corona::screenPool() const
 {
     return m_screenPool;
@@ -560,145 +571,22 @@ QRegion Corona::availableScreenRegionWithCriteria(int id,
         ignoreModes << Latte::Types::NormalWindow;
     }
 
+    const ScreenRegions::Criteria criteria = ScreenRegions::criteria(screen, layout, ignoreModes, ignoreEdges, ignoreExternalPanels, desktopUse);
+
+    if (m_screenRegions->hasRegion(criteria)) {
+        return m_screenRegions->region(criteria);
+    }
+
     bool allEdges = ignoreEdges.isEmpty();
     QList<Latte::View *> views = layout->latteViews();
 
-    for (const auto *view : views) {
+    m_screenRegions->track(layout, screen, views);
+
+    for (auto *view : views) {
         if (view && view->containment() && view->screen() == screen
                 && ((allEdges || !ignoreEdges.contains(view->location()))
                     && (view->visibility() && !ignoreModes.contains(view->visibility()->mode())))) {
-            int realThickness = view->normalThickness();
-
-            int x = 0; int y = 0; int w = 0; int h = 0;
-
-            switch (view->formFactor()) {
-            case Plasma::Types::Horizontal:
-                if (view->behaveAsPlasmaPanel()) {
-                    w = view->width();
-                    x = view->x();
-                } else {
-                    w = view->maxLength() * view->width();
-                    int offsetW = view->offset() * view->width();
-
-                    switch (view->alignment()) {
-                    case Latte::Types::Left:
-                        x = view->x() + offsetW;
-                        break;
-
-                    case Latte::Types::Center:
-                    case Latte::Types::Justify:
-                        x = (view->geometry().center().x() - w/2) + offsetW;
-                        break;
-
-                    case Latte::Types::Right:
-                        x = view->geometry().right() - w - offsetW;
-                        break;
-                    }
-                }
-                break;
-            case Plasma::Types::Vertical:
-                if (view->behaveAsPlasmaPanel()) {
-                    h = view->height();
-                    y = view->y();
-                } else {
-                    h = view->maxLength() * view->height();
-                    int offsetH = view->offset() * view->height();
-
-                    switch (view->alignment()) {
-                    case Latte::Types::Top:
-                        y = view->y() + offsetH;
-                        break;
-
-                    case Latte::Types::Center:
-                    case Latte::Types::Justify:
-                        y = (view->geometry().center().y() - h/2) + offsetH;
-                        break;
-
-                    case Latte::Types::Bottom:
-                        y = view->geometry().bottom() - h - offsetH;
-                        break;
-                    }
-                }
-                break;
-            }
-
-            // Usually availableScreenRect is used by the desktop,
-            // but Latte don't have desktop, then here just
-            // need calculate available space for top and bottom location,
-            // because the left and right are those who dodge others views
-            switch (view->location()) {
-            case Plasma::Types::TopEdge:
-                if (view->behaveAsPlasmaPanel()) {
-                    QRect viewGeometry = view->geometry();
-
-                    if (desktopUse) {
-                        //! ignore any real window slide outs in all cases
-                        viewGeometry.moveTop(view->screen()->geometry().top() + view->screenEdgeMargin());
-                    }
-
-                    available -= viewGeometry;
-                } else {                  
-                    y = view->y();
-                    available -= QRect(x, y, w, realThickness);
-                }
-
-                break;
-
-            case Plasma::Types::BottomEdge:
-                if (view->behaveAsPlasmaPanel()) {
-                    QRect viewGeometry = view->geometry();
-
-                    if (desktopUse) {
-                        //! ignore any real window slide outs in all cases
-                        viewGeometry.moveTop(view->screen()->geometry().bottom() - view->screenEdgeMargin() - viewGeometry.height());
-                    }
-
-                    available -= viewGeometry;
-                } else {
-                    y = view->geometry().bottom() - realThickness + 1;
-                    available -= QRect(x, y, w, realThickness);
-                }
-
-                break;
-
-            case Plasma::Types::LeftEdge:
-                if (view->behaveAsPlasmaPanel()) {
-                    QRect viewGeometry = view->geometry();
-
-                    if (desktopUse) {
-                        //! ignore any real window slide outs in all cases
-                        viewGeometry.moveLeft(view->screen()->geometry().left() + view->screenEdgeMargin());
-                    }
-
-                    available -= viewGeometry;
-                } else {
-                    x = view->x();
-                    available -= QRect(x, y, realThickness, h);
-                }
-
-                break;
-
-            case Plasma::Types::RightEdge:
-                if (view->behaveAsPlasmaPanel()) {
-                    QRect viewGeometry = view->geometry();
-
-                    if (desktopUse) {
-                        //! ignore any real window slide outs in all cases
-                        viewGeometry.moveLeft(view->screen()->geometry().right() - view->screenEdgeMargin() - viewGeometry.width());
-                    }
-
-                    available -= viewGeometry;
-                } else {                    
-                    x = view->geometry().right() - realThickness + 1;
-                    available -= QRect(x, y, realThickness, h);
-                }
-
-                break;
-
-            default:
-                //! bypass clang warnings
-                break;
-            }
+            available -= m_screenRegions->viewBand(view, desktopUse);
         }
     }
 
@@ -710,6 +598,8 @@ QRegion Corona::availableScreenRegionWithCriteria(int id,
 
     qDebug() << "::::: END OF FREE AREAS :::::";*/
 
+    m_screenRegions->setRegion(criteria, available);
+
     return available;
 }
 
@@ -747,9 +637,17 @@ QRect Corona::availableScreenRectWithCriteria(int id,
         ignoreModes << Latte::Types::NormalWindow;
     }
 
+    const ScreenRegions::Criteria criteria = ScreenRegions::criteria(screen, layout, ignoreModes, ignoreEdges, ignoreExternalPanels, desktopUse);
+
+    if (m_screenRegions->hasRect(criteria)) {
+        return m_screenRegions->rect(criteria);
+    }
+
     bool allEdges = ignoreEdges.isEmpty();
     QList<Latte::View *> views = layout->latteViews();
 
+    m_screenRegions->track(layout, screen, views);
+
     for (const auto *view : views) {
         if (view && view->containment() && view->screen() == screen
                 && ((allEdges || !ignoreEdges.contains(view->location()))
@@ -805,6 +703,8 @@ QRect Corona::availableScreenRectWithCriteria(int id,
         }
     }
 
+    m_screenRegions->setRect(criteria, available);
+
     return available;
 }
 
@@ -1070,29 +970,6 @@ void Corona::loadDefaultLayout()
     addViewForLayout(m_layoutsManager->currentLayoutName());
 }
 
-QStringList Corona::containmentsIds()
-{
-    QStringList ids;
-
-    for(const auto containment : containments()) {
-        ids << QString::number(containment->id());
-    }
-
-    return ids;
-}
-
-QStringList Corona::appletsIds()
-{
-    QStringList ids;
-
-    for(const auto containment : containments()) {
-        auto applets = containment->config().group("Applets");
-        ids << applets.groupList();
-    }
-
-    return ids;
-}
-
 //! Activate launcher menu through dbus interface
 void Corona::activateLauncherMenu()
 {
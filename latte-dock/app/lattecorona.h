@@ -63,7 +63,9 @@ class PlasmaShell;
 
 namespace Latte {
 class CentralLayout;
+class IdsAllocator;
 class ScreenPool;
+class ScreenRegions;
 class GlobalShortcuts;
 class UniversalSettings;
 class View;
@@ -131,6 +133,7 @@ public:
 
     KActivities::Consumer *activitiesConsumer() const;
     GlobalShortcuts *globalShortcuts() const;
+    IdsAllocator *idsAllocator() const;
     ScreenPool *screenPool() const;
     UniversalSettings *universalSettings() const;
     Layouts::Manager *layoutsManager() const;   
@@ -199,9 +202,6 @@ private:
 
     int primaryScreenId() const;
 
-    QStringList containmentsIds();
-    QStringList appletsIds();
-
     Layout::GenericLayout *layout(QString name) const;
     CentralLayout *centralLayout(QString name) const;
 
@@ -226,7 +226,9 @@ private:
     KActivities::Consumer *m_activitiesConsumer;
     QPointer<KAboutApplicationDialog> aboutDialog;
 
+    IdsAllocator *m_idsAllocator{nullptr};
     ScreenPool *m_screenPool{nullptr};
+    ScreenRegions *m_screenRegions{nullptr};
     UniversalSettings *m_universalSettings{nullptr};
     GlobalShortcuts *m_globalShortcuts{nullptr};
 
@@ -325,31 +325,51 @@ QString AbstractLayout::layoutName(const QString &fileName)
     return layoutName;
 }
 
-void AbstractLayout::loadConfig()
+void AbstractLayout::readSettings(const KConfigGroup &layoutGroup, StoredSettings &settings)
 {
-    m_version = m_layoutGroup.readEntry("version", 2);
-    m_launchers = m_layoutGroup.readEntry("launchers", QStringList());
-    m_lastUsedActivity = m_layoutGroup.readEntry("lastUsedActivity", QString());
-    m_preferredForShortcutsTouched = m_layoutGroup.readEntry("preferredForShortcutsTouched", false);
+    settings.version = layoutGroup.readEntry("version", 2);
+    settings.launchers = layoutGroup.readEntry("launchers", QStringList());
+    settings.lastUsedActivity = layoutGroup.readEntry("lastUsedActivity", QString());
+    settings.preferredForShortcutsTouched = layoutGroup.readEntry("preferredForShortcutsTouched", false);
+
+    settings.color = layoutGroup.readEntry("color", QString("blue"));
+    settings.backgroundStyle = static_cast<BackgroundStyle>(layoutGroup.readEntry("backgroundStyle", (int)ColorBackgroundStyle));
 
-    m_color = m_layoutGroup.readEntry("color", QString("blue"));
-    m_backgroundStyle = static_cast<BackgroundStyle>(m_layoutGroup.readEntry("backgroundStyle", (int)ColorBackgroundStyle));
+    QString deprecatedTextColor = layoutGroup.readEntry("textColor", QString("fcfcfc"));
+    QString deprecatedBackground = layoutGroup.readEntry("background", QString());
 
-    QString deprecatedTextColor = m_layoutGroup.readEntry("textColor", QString("fcfcfc"));
-    QString deprecatedBackground = m_layoutGroup.readEntry("background", QString());
+    settings.hasDeprecatedBackground = deprecatedBackground.startsWith("/");
 
-    if (deprecatedBackground.startsWith("/")) {
-        m_customBackground = deprecatedBackground;
-        m_customTextColor = deprecatedTextColor;
-        setBackgroundStyle(PatternBackgroundStyle);
+    if (settings.hasDeprecatedBackground) {
+        settings.customBackground = deprecatedBackground;
+        settings.customTextColor = deprecatedTextColor;
+        settings.backgroundStyle = PatternBackgroundStyle;
+    } else {
+        settings.customBackground = layoutGroup.readEntry("customBackground", QString(""));
+        settings.customTextColor = layoutGroup.readEntry("customTextColor", QString("fcfcfc"));
+    }
+}
 
+void AbstractLayout::loadConfig()
+{
+    StoredSettings settings;
+    readSettings(m_layoutGroup, settings);
+
+    m_version = settings.version;
+    m_launchers = settings.launchers;
+    m_lastUsedActivity = settings.lastUsedActivity;
+    m_preferredForShortcutsTouched = settings.preferredForShortcutsTouched;
+
+    m_color = settings.color;
+    m_backgroundStyle = settings.backgroundStyle;
+    m_customBackground = settings.customBackground;
+    m_customTextColor = settings.customTextColor;
+
+    if (settings.hasDeprecatedBackground) {
         m_layoutGroup.writeEntry("background", QString());
         m_layoutGroup.writeEntry("textColor", QString());
 
         saveConfig();
-    } else {
-        m_customBackground = m_layoutGroup.readEntry("customBackground", QString(""));
-        m_customTextColor = m_layoutGroup.readEntry("customTextColor", QString("fcfcfc"));
     }
 }
 
@@ -22,6 +22,8 @@
 
 // Qt
 #include <QObject>
+#include <QString>
+#include <QStringList>
 
 // KDE
 #include <KConfigGroup>
@@ -58,6 +60,30 @@ Q_ENUM_NS(BackgroundStyle);
 namespace Latte {
 namespace Layout {
 
+//! values of the LayoutSettings group of a layout file as the layouts load them,
+//! AbstractLayout::readSettings() and CentralLayout::readSettings() fill them
+struct StoredSettings
+{
+    bool preferredForShortcutsTouched{false};
+    //! background and text color were found in their pre-v0.10 entries
+    bool hasDeprecatedBackground{false};
+    int version{2};
+
+    BackgroundStyle backgroundStyle{ColorBackgroundStyle};
+
+    QString color;
+    QString customBackground;
+    QString customTextColor;
+    QString lastUsedActivity;
+    QStringList launchers;
+
+    //! central layouts
+    bool disableBordersForMaximizedWindows{false};
+    bool showInMenu{false};
+    QString sharedLayoutName;
+    QStringList activities;
+};
+
 class AbstractLayout : public QObject
 {
     Q_OBJECT
@@ -116,6 +142,7 @@ public:
 // STATIC
     static QString defaultTextColor(const QString &color);
     static QString layoutName(const QString &fileName);
+    static void readSettings(const KConfigGroup &layoutGroup, StoredSettings &settings);
     static QList<Plasma::Types::Location> combinedFreeEdges(const QList<Plasma::Types::Location> &edges1,
                                                             const QList<Plasma::Types::Location> &edges2);
 
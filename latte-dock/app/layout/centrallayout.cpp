@@ -207,6 +207,7 @@ void CentralLayout::setSharedLayout(SharedLayout *layout)
 
         //! attach new signals
         m_sharedConnections << connect(m_sharedLayout, &Layout::GenericLayout::viewsCountChanged, this, &Layout::GenericLayout::viewsCountChanged);
+        m_sharedConnections << connect(m_sharedLayout, &Layout::GenericLayout::sortedLatteViewsInvalidated, this, &Layout::GenericLayout::invalidateSortedLatteViews);
         m_sharedConnections << connect(m_sharedLayout, &Layout::AbstractLayout::nameChanged, this, [this]() {
             setSharedLayoutName(m_sharedLayout->name());
         });
@@ -251,16 +252,32 @@ Latte::View *CentralLayout::lastConfigViewFor()
     }
 }
 
-void CentralLayout::loadConfig()
+void CentralLayout::readSettings(const KConfigGroup &layoutGroup, Layout::StoredSettings &settings)
 {
-    m_disableBordersForMaximizedWindows = m_layoutGroup.readEntry("disableBordersForMaximizedWindows", false);
-    m_showInMenu = m_layoutGroup.readEntry("showInMenu", false);     
-    m_activities = m_layoutGroup.readEntry("activities", QStringList());
+    Layout::AbstractLayout::readSettings(layoutGroup, settings);
+
+    settings.disableBordersForMaximizedWindows = layoutGroup.readEntry("disableBordersForMaximizedWindows", false);
+    settings.showInMenu = layoutGroup.readEntry("showInMenu", false);
+    settings.activities = layoutGroup.readEntry("activities", QStringList());
 
-    QString sharedLayoutName = m_layoutGroup.readEntry("sharedLayout", QString());
+    QString sharedLayoutName = layoutGroup.readEntry("sharedLayout", QString());
 
     if (Layouts::Importer::layoutExists(sharedLayoutName)) {
-        m_sharedLayoutName = sharedLayoutName;
+        settings.sharedLayoutName = sharedLayoutName;
+    }
+}
+
+void CentralLayout::loadConfig()
+{
+    Layout::StoredSettings settings;
+    readSettings(m_layoutGroup, settings);
+
+    m_disableBordersForMaximizedWindows = settings.disableBordersForMaximizedWindows;
+    m_showInMenu = settings.showInMenu;
+    m_activities = settings.activities;
+
+    if (!settings.sharedLayoutName.isEmpty()) {
+        m_sharedLayoutName = settings.sharedLayoutName;
     }
 
     emit activitiesChanged();
@@ -460,13 +477,6 @@ Types::ViewType CentralLayout::latteViewType(uint containmentId) const
     return Types::DockView;
 }
 
-QList<Latte::View *> CentralLayout::sortedLatteViews(QList<Latte::View *> views)
-{
-    QList<Latte::View *> vws = latteViews();
-
-    return Layout::GenericLayout::sortedLatteViews(vws);
-}
-
 QList<Latte::View *> CentralLayout::viewsWithPlasmaShortcuts()
 {
     QList<Latte::View *> combined = Layout::GenericLayout::viewsWithPlasmaShortcuts();
@@ -70,6 +70,9 @@ public:
     SharedLayout *sharedLayout() const;
     void setSharedLayout(SharedLayout *layout);
 
+    //! reads both the generic and the central settings of a layout file
+    static void readSettings(const KConfigGroup &layoutGroup, Layout::StoredSettings &settings);
+
     //! OVERRIDE GeneralLayout implementations
     void addView(Plasma::Containment *containment, bool forceOnPrimary = false, int explicitScreen = -1, Layout::ViewsMap *occupied = nullptr) override;
     void syncLatteViewsToScreens(Layout::ViewsMap *occupiedMap = nullptr) override;
@@ -93,7 +96,6 @@ public:
     QList<Plasma::Types::Location> freeEdges(QScreen *scr) const override;
     QList<Plasma::Types::Location> freeEdges(int screen) const override;
 
-    QList<Latte::View *> sortedLatteViews(QList<Latte::View *> views = QList<Latte::View *>()) override;
     QList<Latte::View *> viewsWithPlasmaShortcuts() override;
 
 signals:
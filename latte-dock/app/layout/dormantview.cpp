@@ -0,0 +1,224 @@
+/*
+*  Copyright 2020  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "dormantview.h"
+
+// local
+#include "genericlayout.h"
+#include "../lattecorona.h"
+#include "../wm/abstractwindowinterface.h"
+
+// Qt
+#include <QDebug>
+#include <QPainter>
+
+// KDE
+#include <KWayland/Client/plasmashell.h>
+#include <KWayland/Client/surface.h>
+#include <KWindowSystem>
+
+// Plasma
+#include <Plasma/Containment>
+
+#define DORMANTVIEWTHICKNESS 1
+
+namespace Latte {
+namespace Layout {
+
+DormantView::DormantView(GenericLayout *layout, Plasma::Containment *containment, QScreen *screen, Latte::Types::Visibility mode)
+    : m_mode(mode),
+      m_screen(screen),
+      m_corona(layout->corona()),
+      m_layout(layout),
+      m_containment(containment)
+{
+    setTitle(QString("#dormantview#" + QString::number(containment->id())));
+    setScreen(screen);
+
+    setFlags(Qt::FramelessWindowHint
+             | Qt::WindowStaysOnTopHint
+             | Qt::NoDropShadowWindowHint
+             | Qt::WindowDoesNotAcceptFocus);
+
+    QSurfaceFormat format;
+    format.setAlphaBufferSize(8);
+    setFormat(format);
+
+    //! SideBars are revealed only through GenericLayout::toggleHiddenState()
+    if (m_mode != Latte::Types::AutoHide) {
+        return;
+    }
+
+    connect(m_screen, &QScreen::geometryChanged, this, &DormantView::updateGeometry);
+    connect(m_layout, &GenericLayout::activitiesChanged, this, &DormantView::updateActivities);
+
+    setupWaylandIntegration();
+    updateGeometry();
+    show();
+
+    if (KWindowSystem::isPlatformX11()) {
+        m_trackedWindowId = winId();
+        m_corona->wm()->registerIgnoredWindow(m_trackedWindowId);
+    }
+
+    updateActivities();
+}
+
+DormantView::~DormantView()
+{
+    if (m_corona && !m_trackedWindowId.isNull()) {
+        m_corona->wm()->unregisterIgnoredWindow(m_trackedWindowId);
+    }
+
+    if (m_shellSurface) {
+        delete m_shellSurface;
+    }
+}
+
+Plasma::Types::Location DormantView::location() const
+{
+    return m_containment->location();
+}
+
+Latte::Types::Visibility DormantView::mode() const
+{
+    return m_mode;
+}
+
+QString DormantView::screenName() const
+{
+    return m_screen ? m_screen->name() : QString();
+}
+
+Plasma::Containment *DormantView::containment() const
+{
+    return m_containment;
+}
+
+void DormantView::updateActivities()
+{
+    if (m_layout && isVisible()) {
+        m_corona->wm()->setWindowOnActivities(*this, m_layout->appliedActivities());
+    }
+}
+
+void DormantView::updateGeometry()
+{
+    if (!m_screen) {
+        return;
+    }
+
+    QRect screenGeometry = m_screen->geometry();
+    QRect newGeometry;
+
+    switch (location()) {
+    case Plasma::Types::TopEdge:
+        newGeometry = QRect(screenGeometry.left(), screenGeometry.top(), screenGeometry.width(), DORMANTVIEWTHICKNESS);
+        break;
+    case Plasma::Types::LeftEdge:
+        newGeometry = QRect(screenGeometry.left(), screenGeometry.top(), DORMANTVIEWTHICKNESS, screenGeometry.height());
+        break;
+    case Plasma::Types::RightEdge:
+        newGeometry = QRect(screenGeometry.right() - DORMANTVIEWTHICKNESS + 1, screenGeometry.top(), DORMANTVIEWTHICKNESS, screenGeometry.height());
+        break;
+    default:
+        newGeometry = QRect(screenGeometry.left(), screenGeometry.bottom() - DORMANTVIEWTHICKNESS + 1, screenGeometry.width(), DORMANTVIEWTHICKNESS);
+        break;
+    }
+
+    setMinimumSize(newGeometry.size());
+    setMaximumSize(newGeometry.size());
+    setGeometry(newGeometry);
+
+    if (m_shellSurface) {
+        m_shellSurface->setPosition(newGeometry.topLeft());
+    }
+}
+
+void DormantView::setupWaylandIntegration()
+{
+    if (m_shellSurface || !KWindowSystem::isPlatformWayland() || !m_corona) {
+        return;
+    }
+
+    using namespace KWayland::Client;
+
+    PlasmaShell *interface = m_corona->waylandCoronaInterface();
+
+    if (!interface) {
+        return;
+    }
+
+    //! the native window must exist before its wayland surface can be retrieved
+    create();
+
+    Surface *s = Surface::fromWindow(this);
+
+    if (!s) {
+        return;
+    }
+
+    qDebug() << "wayland dormant view surface was created...";
+    m_shellSurface = interface->createSurface(s, this);
+    m_corona->wm()->setViewExtraFlags(m_shellSurface);
+
+    m_shellSurface->setPanelTakesFocus(false);
+}
+
+void DormantView::paintEvent(QPaintEvent *ev)
+{
+    Q_UNUSED(ev)
+
+    QPainter painter(this);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(QRect(QPoint(0, 0), size()), Qt::transparent);
+}
+
+bool DormantView::event(QEvent *ev)
+{
+    switch (ev->type()) {
+    case QEvent::Show:
+        if (m_corona) {
+            if (m_shellSurface) {
+                m_corona->wm()->setViewExtraFlags(m_shellSurface);
+            } else {
+                m_corona->wm()->setViewExtraFlags(this);
+            }
+        }
+        break;
+
+    case QEvent::Enter:
+    case QEvent::DragEnter:
+        if (!m_activated) {
+            //! the real view is created only once
+            m_activated = true;
+            qDebug() << "dormant view activated for containment :: " << m_containment->id();
+            emit activated();
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return QRasterWindow::event(ev);
+}
+
+}
+}
@@ -0,0 +1,111 @@
+/*
+*  Copyright 2020  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DORMANTVIEW_H
+#define DORMANTVIEW_H
+
+// local
+#include <coretypes.h>
+#include "../wm/windowinfowrap.h"
+
+// Qt
+#include <QPointer>
+#include <QRasterWindow>
+#include <QScreen>
+
+// Plasma
+#include <Plasma>
+
+namespace KWayland {
+namespace Client {
+class PlasmaShellSurface;
+}
+}
+
+namespace Plasma {
+class Containment;
+}
+
+namespace Latte {
+class Corona;
+namespace Layout {
+class GenericLayout;
+}
+}
+
+namespace Latte {
+namespace Layout {
+
+//! What is the importance of this class?
+//!
+//! A DormantView is the placeholder of a Latte::View that is hidden most of the
+//! time (AutoHide and SideBar modes). Its containment is loaded as a config stub
+//! only and the full Latte::View together with its QML scene is created the first
+//! time the user reveals it. AutoHide views are revealed through a thin transparent
+//! window at their screen edge, SideBar views through GenericLayout::toggleHiddenState()
+//! so they do not need any window at all.
+
+class DormantView : public QRasterWindow
+{
+    Q_OBJECT
+
+public:
+    DormantView(GenericLayout *layout, Plasma::Containment *containment, QScreen *screen, Latte::Types::Visibility mode);
+    ~DormantView() override;
+
+    Plasma::Types::Location location() const;
+    Latte::Types::Visibility mode() const;
+    QString screenName() const;
+
+    Plasma::Containment *containment() const;
+
+signals:
+    void activated();
+
+protected:
+    bool event(QEvent *ev) override;
+    void paintEvent(QPaintEvent *ev) override;
+
+private slots:
+    void updateActivities();
+    void updateGeometry();
+
+private:
+    void setupWaylandIntegration();
+
+private:
+    bool m_activated{false};
+
+    Latte::Types::Visibility m_mode{Latte::Types::AutoHide};
+
+    QPointer<QScreen> m_screen;
+    QPointer<Latte::Corona> m_corona;
+    QPointer<GenericLayout> m_layout;
+
+    Plasma::Containment *m_containment{nullptr};
+
+    Latte::WindowSystem::WindowId m_trackedWindowId;
+
+    KWayland::Client::PlasmaShellSurface *m_shellSurface{nullptr};
+};
+
+}
+}
+
+#endif
@@ -21,6 +21,7 @@
 
 // local
 #include "abstractlayout.h"
+#include "dormantview.h"
 #include "storage.h"
 #include "../apptypes.h"
 #include "../lattecorona.h"
@@ -28,13 +29,16 @@
 #include "../layouts/importer.h"
 #include "../layouts/manager.h"
 #include "../layouts/synchronizer.h"
+#include "../settings/universalsettings.h"
 #include "../shortcuts/shortcutstracker.h"
 #include "../view/view.h"
 #include "../view/positioner.h"
+#include "../view/visibilitymanager.h"
 
 // Qt
 #include <QDebug>
 #include <QScreen>
+#include <QSharedPointer>
 
 // Plasma
 #include <Plasma>
@@ -51,6 +55,13 @@ GenericLayout::GenericLayout(QObject *parent, QString layoutFile, QString assign
     : AbstractLayout (parent, layoutFile, assignedName),
       m_storage(new Storage(this))
 {
+    connect(this, &GenericLayout::viewsCountChanged, this, &GenericLayout::invalidateSortedLatteViews);
+    connect(this, &GenericLayout::viewEdgeChanged, this, &GenericLayout::invalidateSortedLatteViews);
+
+    //! screens priorities depend on the primary screen and the screens order
+    connect(qGuiApp, &QGuiApplication::primaryScreenChanged, this, &GenericLayout::invalidateSortedLatteViews);
+    connect(qGuiApp, &QGuiApplication::screenAdded, this, &GenericLayout::invalidateSortedLatteViews);
+    connect(qGuiApp, &QGuiApplication::screenRemoved, this, &GenericLayout::invalidateSortedLatteViews);
 }
 
 GenericLayout::~GenericLayout()
@@ -134,8 +145,15 @@ void GenericLayout::unloadLatteViews()
 
     qDeleteAll(m_latteViews);
     qDeleteAll(m_waitingLatteViews);
+    qDeleteAll(m_dormantViews);
     m_latteViews.clear();
     m_waitingLatteViews.clear();
+    m_dormantViews.clear();
+    m_awakenedContainments.clear();
+
+    //! the sorted views cache must not keep pointers to the deleted views
+    m_sortedLatteViews.clear();
+    m_sortedLatteViewsDirty = true;
 }
 
 bool GenericLayout::blockAutomaticLatteViewCreation() const
@@ -152,6 +170,44 @@ void GenericLayout::setBlockAutomaticLatteViewCreation(bool block)
     m_blockAutomaticLatteViewCreation = block;
 }
 
+bool GenericLayout::isWarm() const
+{
+    return m_isWarm;
+}
+
+void GenericLayout::setIsWarm(bool warm)
+{
+    if (m_isWarm == warm) {
+        return;
+    }
+
+    m_isWarm = warm;
+
+    if (!m_isWarm) {
+        //! views are created afterwards through syncLatteViewsToScreens()
+        return;
+    }
+
+    //! the views of a warm layout would be shown at all activities because none of
+    //! its activities is running, so they are released until the layout is activated
+    for (const auto containment : m_dormantViews.keys()) {
+        removeDormantView(containment);
+    }
+
+    QList<Latte::View *> views = m_latteViews.values() + m_waitingLatteViews.values();
+    m_latteViews.clear();
+    m_waitingLatteViews.clear();
+    m_awakenedContainments.clear();
+
+    for (const auto view : views) {
+        view->disconnectSensitiveSignals();
+        view->deleteLater();
+    }
+
+    invalidateSortedLatteViews();
+    emit viewsCountChanged();
+}
+
 bool GenericLayout::isActive() const
 {
     if (!m_corona) {
@@ -296,6 +352,12 @@ QList<Plasma::Types::Location> GenericLayout::freeEdges(QScreen *scr) const
         }
     }
 
+    for (const auto dormantView : m_dormantViews) {
+        if (dormantView->screenName() == scr->name()) {
+            edges.removeOne(dormantView->location());
+        }
+    }
+
     return edges;
 }
 
@@ -317,6 +379,12 @@ QList<Plasma::Types::Location> GenericLayout::freeEdges(int screen) const
         }
     }
 
+    for (const auto dormantView : m_dormantViews) {
+        if (scr && dormantView->screenName() == scr->name()) {
+            edges.removeOne(dormantView->location());
+        }
+    }
+
     return edges;
 }
 
@@ -396,7 +464,27 @@ QList<Latte::View *> GenericLayout::latteViews()
 
 QList<Latte::View *> GenericLayout::sortedLatteViews(QList<Latte::View *> views)
 {
-    QList<Latte::View *> sortedViews = views.isEmpty() ? latteViews() : views;
+    if (!views.isEmpty()) {
+        return sortLatteViews(views);
+    }
+
+    if (m_sortedLatteViewsDirty) {
+        m_sortedLatteViews = sortLatteViews(latteViews());
+        m_sortedLatteViewsDirty = false;
+    }
+
+    return m_sortedLatteViews;
+}
+
+void GenericLayout::invalidateSortedLatteViews()
+{
+    m_sortedLatteViewsDirty = true;
+    emit sortedLatteViewsInvalidated();
+}
+
+QList<Latte::View *> GenericLayout::sortLatteViews(QList<Latte::View *> views)
+{
+    QList<Latte::View *> sortedViews = views;
 
     qDebug() << " -------- ";
 
@@ -692,6 +780,9 @@ void GenericLayout::containmentDestroyed(QObject *cont)
             m_containments.removeAt(containmentIndex);
         }
 
+        removeDormantView(containment);
+        m_awakenedContainments.removeAll(containment);
+
         qDebug() << "Layout " << name() << " :: containment destroyed!!!!";
         auto view = m_latteViews.take(containment);
 
@@ -770,6 +861,11 @@ void GenericLayout::addView(Plasma::Containment *containment, bool forceOnPrimar
         return;
     }
 
+    if (m_isWarm) {
+        qDebug() << "delaying LatteView creation for warm layout containment :: " << containment->id();
+        return;
+    }
+
     qDebug() << "step 1...";
 
     if (!m_storage->isLatteContainment(containment))
@@ -782,6 +878,10 @@ void GenericLayout::addView(Plasma::Containment *containment, bool forceOnPrimar
             return;
     }
 
+    if (m_dormantViews.contains(containment)) {
+        return;
+    }
+
     qDebug() << "step 3...";
 
     QScreen *nextScreen{qGuiApp->primaryScreen()};
@@ -856,6 +956,17 @@ void GenericLayout::addView(Plasma::Containment *containment, bool forceOnPrimar
                 auto viewToDelete = m_latteViews.take(testContainment);
                 viewToDelete->disconnectSensitiveSignals();
                 viewToDelete->deleteLater();
+                invalidateSortedLatteViews();
+            }
+        }
+
+        for (const Plasma::Containment *testContainment : m_dormantViews.keys()) {
+            int testScreenId = testContainment->screen() == -1 ? testContainment->lastScreen() : testContainment->screen();
+            bool testOnPrimary = testContainment->config().readEntry("onPrimary", true);
+
+            if (!testOnPrimary && m_corona->screenPool()->primaryScreenId() == testScreenId && testContainment->location() == containment->location()) {
+                qDebug() << "Rejected explicit dormant view in order add an onPrimary with higher priority at screen: " << connector;
+                removeDormantView(testContainment);
             }
         }
     }
@@ -877,6 +988,19 @@ void GenericLayout::addView(Plasma::Containment *containment, bool forceOnPrimar
         byPassWM = containment->config().readEntry("byPassWM", false);
     }
 
+    if (viewCanBeDormant(containment, mode)) {
+        qDebug() << "Adding dormant view for containment :: " << containment->id();
+        auto dormantView = new DormantView(this, containment, nextScreen, mode);
+        m_dormantViews[containment] = dormantView;
+
+        connect(dormantView, &DormantView::activated, this, [this, containment]() {
+            wakeUpView(containment);
+        });
+
+        emit viewEdgeChanged();
+        return;
+    }
+
     auto latteView = new Latte::View(m_corona, nextScreen, byPassWM);
 
     latteView->init(containment);
@@ -915,6 +1039,20 @@ void GenericLayout::toggleHiddenState(QString screenName, Plasma::Types::Locatio
         validScreenName = screenName;
     }
 
+    Plasma::Containment *dormantContainment{nullptr};
+
+    for (const auto dormantView : m_dormantViews) {
+        if (dormantView->screenName() == validScreenName && dormantView->location() == edge) {
+            dormantContainment = dormantView->containment();
+            break;
+        }
+    }
+
+    if (dormantContainment) {
+        wakeUpView(dormantContainment, true);
+        return;
+    }
+
     int viewsOnEdge{0};
 
     for(const auto view : latteViews()) {
@@ -1059,6 +1197,7 @@ QList<Plasma::Containment *> GenericLayout::unassignFromLayout(Latte::View *latt
 
     if (containments.size() > 0) {
         m_latteViews.remove(latteView->containment());
+        invalidateSortedLatteViews();
     }
 
     //! sync the original layout file for integrity
@@ -1087,6 +1226,7 @@ void GenericLayout::recreateView(Plasma::Containment *containment, bool delayed)
         //! step:2 add the new latteview
         connect(view, &QObject::destroyed, this, [this, containment]() {
             auto view = m_latteViews.take(containment);
+            invalidateSortedLatteViews();
             QTimer::singleShot(250, this, [this, containment]() {
                 if (!m_latteViews.contains(containment)) {
                     qDebug() << "recreate - step 2: adding dock for containment:" << containment->id();
@@ -1101,6 +1241,62 @@ void GenericLayout::recreateView(Plasma::Containment *containment, bool delayed)
 }
 
 
+bool GenericLayout::viewCanBeDormant(Plasma::Containment *containment, Types::Visibility mode) const
+{
+    return m_corona->universalSettings()->lazyViews()
+            && !m_blockAutomaticLatteViewCreation
+            && !m_awakenedContainments.contains(containment)
+            && (mode == Types::AutoHide || mode == Types::SideBar);
+}
+
+void GenericLayout::removeDormantView(const Plasma::Containment *containment)
+{
+    auto dormantView = m_dormantViews.take(containment);
+
+    if (dormantView) {
+        dormantView->deleteLater();
+        emit viewEdgeChanged();
+    }
+}
+
+void GenericLayout::wakeUpView(Plasma::Containment *containment, bool reveal)
+{
+    if (!m_dormantViews.contains(containment)) {
+        return;
+    }
+
+    qDebug() << "Waking up dormant view for containment :: " << containment->id();
+
+    removeDormantView(containment);
+    m_awakenedContainments << containment;
+
+    addView(containment);
+
+    if (!reveal || !m_latteViews.contains(containment)) {
+        return;
+    }
+
+    Latte::View *view = m_latteViews[containment];
+
+    if (view->interfacesGraphicObj()) {
+        if (view->visibility()) {
+            view->visibility()->toggleHiddenState();
+        }
+        return;
+    }
+
+    //! reveal the view only when its QML scene has been loaded and has registered its interfaces
+    QSharedPointer<QMetaObject::Connection> readyConnection(new QMetaObject::Connection);
+
+    *readyConnection = connect(view, &Latte::View::interfacesGraphicObjChanged, this, [view, readyConnection]() {
+        disconnect(*readyConnection);
+
+        if (view->interfacesGraphicObj() && view->visibility()) {
+            view->visibility()->toggleHiddenState();
+        }
+    });
+}
+
 bool GenericLayout::latteViewExists(Plasma::Containment *containment)
 {
     if (!m_corona) {
@@ -1128,6 +1324,12 @@ QList<Plasma::Types::Location> GenericLayout::availableEdgesForView(QScreen *scr
         }
     }
 
+    for (const auto dormantView : m_dormantViews) {
+        if (dormantView->screenName() == scr->name()) {
+            edges.removeOne(dormantView->location());
+        }
+    }
+
     return edges;
 }
 
@@ -1317,6 +1519,11 @@ void GenericLayout::syncLatteViewsToScreens(Layout::ViewsMap *occupiedMap)
     qDebug() << "PRIMARY SCREEN :: " << prmScreenName;
     qDebug() << "LATTEVIEWS MAP :: " << viewsMap;
 
+    //! dormant views are cheap, they are recreated at their valid screens
+    for (const auto containment : m_dormantViews.keys()) {
+        removeDormantView(containment);
+    }
+
     //! add views
     for (const auto containment : m_containments) {
         int screenId = containment->screen();
@@ -1347,6 +1554,7 @@ void GenericLayout::syncLatteViewsToScreens(Layout::ViewsMap *occupiedMap)
         qDebug() << "syncLatteViewsToScreens: view must be deleted... for containment:" << containment->id() << " at screen:" << view->positioner()->currentScreenName();
         view->disconnectSensitiveSignals();
         view->deleteLater();
+        invalidateSortedLatteViews();
     }
 
     //! reconsider views
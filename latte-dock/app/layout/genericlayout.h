@@ -83,6 +83,10 @@ public:
     bool initToCorona(Latte::Corona *corona);
 
     bool isActive() const; //! is loaded and running
+    //! warm layouts keep their containments loaded but create no views
+    //! until they become active again
+    bool isWarm() const;
+    void setIsWarm(bool warm);
     virtual bool isCurrent() const;
     bool isWritable() const;
     bool layoutIsBroken() const;
@@ -152,6 +156,10 @@ public slots:
 
     void toggleHiddenState(QString screenName, Plasma::Types::Location edge);
 
+    //! views priorities must be recalculated because views were added/removed or
+    //! their screen, edge or preference for shortcuts changed
+    void invalidateSortedLatteViews();
+
 signals:
     void activitiesChanged(); // to move at an interface
     void viewsCountChanged();
@@ -164,6 +172,8 @@ signals:
     //! to use the global shortcuts activations
     void preferredViewForShortcutsChanged(Latte::View *view);
 
+    void sortedLatteViewsInvalidated();
+
 protected:
     void updateLastUsedActivity();
 
@@ -190,6 +200,8 @@ private:
     bool explicitDockOccupyEdge(int screen, Plasma::Types::Location location) const;
     bool primaryDockOccupyEdge(Plasma::Types::Location location) const;
 
+    QList<Latte::View *> sortLatteViews(QList<Latte::View *> views);
+
     bool viewAtLowerScreenPriority(Latte::View *test, Latte::View *base);
     bool viewAtLowerEdgePriority(Latte::View *test, Latte::View *base);
 
@@ -199,15 +211,26 @@ private:
 
     bool mapContainsId(const ViewsMap *map, uint viewId) const;
 
+    //! Dormant Views are views that are hidden most of the time and
+    //! whose Latte::View is created only when they are revealed
+    bool viewCanBeDormant(Plasma::Containment *containment, Types::Visibility mode) const;
+    void removeDormantView(const Plasma::Containment *containment);
+    void wakeUpView(Plasma::Containment *containment, bool reveal = false);
+
     QList<int> containmentSystrays(Plasma::Containment *containment) const;
 
     QList<ViewData> sortedViewsData(const QList<ViewData> &viewsData);
 
 private:
     bool m_blockAutomaticLatteViewCreation{false};
+    bool m_isWarm{false};
+    bool m_sortedLatteViewsDirty{true};
 
     QPointer<Latte::View> m_lastConfigViewFor;
 
+    //! views ordered by their priority, it is updated only after it was invalidated
+    QList<Latte::View *> m_sortedLatteViews;
+
     QStringList m_unloadedContainmentsIds;
 
     QPointer<Storage> m_storage;
@@ -215,6 +238,10 @@ private:
     //! try to avoid crashes from recreating the same views all the time
     QList<const Plasma::Containment *> m_viewsToRecreate;
 
+    QHash<const Plasma::Containment *, DormantView *> m_dormantViews;
+    //! containments whose views have been revealed once and must not become dormant again
+    QList<const Plasma::Containment *> m_awakenedContainments;
+
     friend class Storage;
     friend class Latte::View;
 };
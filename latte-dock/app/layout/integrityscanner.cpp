@@ -0,0 +1,222 @@
+/*
+*  Copyright 2020  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "integrityscanner.h"
+
+// Qt
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSet>
+#include <QtConcurrent>
+
+namespace Latte {
+namespace Layout {
+
+bool IntegrityReport::hasDuplicatedIds() const
+{
+    QSet<QString> ids;
+
+    for (const auto &id : containments + applets) {
+        if (ids.contains(id)) {
+            return true;
+        }
+
+        ids << id;
+    }
+
+    return false;
+}
+
+IntegrityScanner::IntegrityScanner()
+{
+}
+
+IntegrityScanner *IntegrityScanner::self()
+{
+    static IntegrityScanner scanner;
+    return &scanner;
+}
+
+IntegrityReport IntegrityScanner::scan(const QString &file)
+{
+    QFileInfo info(file);
+
+    if (file.isEmpty() || !info.exists()) {
+        return IntegrityReport();
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        if (m_reports.contains(file)) {
+            const CachedReport &cached = m_reports[file];
+
+            if (cached.lastModified == info.lastModified() && cached.size == info.size()) {
+                return cached.report;
+            }
+        }
+    }
+
+    CachedReport cached;
+    cached.lastModified = info.lastModified();
+    cached.size = info.size();
+    cached.report = parse(file);
+
+    QMutexLocker locker(&m_mutex);
+    m_reports[file] = cached;
+
+    return cached.report;
+}
+
+void IntegrityScanner::prefetch(const QStringList &files)
+{
+    QStringList toScan = files;
+
+    QtConcurrent::blockingMap(toScan, [this](const QString &file) {
+        scan(file);
+    });
+}
+
+IntegrityReport IntegrityScanner::parse(const QString &file) const
+{
+    IntegrityReport report;
+
+    QFile layoutFile(file);
+
+    if (!layoutFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return report;
+    }
+
+    struct AppletRecord {
+        QSet<QString> keys;
+        QSet<QString> groups;
+        QSet<QString> configurationKeys;
+    };
+
+    //! only groups that contain entries are taken into account, same as KConfig does
+    QStringList containments;
+    QHash<QString, QStringList> containmentApplets;
+    QHash<QString, AppletRecord> applets;
+
+    QStringList group;
+
+    while (!layoutFile.atEnd()) {
+        const QString line = QString::fromUtf8(layoutFile.readLine()).trimmed();
+
+        if (line.isEmpty() || line.startsWith(QLatin1Char('#'))) {
+            continue;
+        }
+
+        if (line.startsWith(QLatin1Char('['))) {
+            group.clear();
+
+            int start = 0;
+
+            while (start < line.length() && line.at(start) == QLatin1Char('[')) {
+                int end = line.indexOf(QLatin1Char(']'), start);
+
+                if (end < 0) {
+                    break;
+                }
+
+                QString name = line.mid(start + 1, end - start - 1);
+
+                //! group options such as [$i]
+                if (!name.startsWith(QLatin1Char('$'))) {
+                    group << name;
+                }
+
+                start = end + 1;
+            }
+
+            continue;
+        }
+
+        int separator = line.indexOf(QLatin1Char('='));
+
+        if (separator <= 0 || group.count() < 2 || group[0] != QLatin1String("Containments")) {
+            continue;
+        }
+
+        QString key = line.left(separator).trimmed();
+        int keyOptions = key.indexOf(QLatin1Char('['));
+
+        if (keyOptions > 0) {
+            key = key.left(keyOptions);
+        }
+
+        const QString &cId = group[1];
+
+        if (!containmentApplets.contains(cId)) {
+            containments << cId;
+            containmentApplets[cId] = QStringList();
+        }
+
+        if (group.count() < 4 || group[2] != QLatin1String("Applets")) {
+            continue;
+        }
+
+        const QString &aId = group[3];
+        const QString appletKey = cId + QLatin1Char('/') + aId;
+
+        if (!applets.contains(appletKey)) {
+            containmentApplets[cId] << aId;
+        }
+
+        AppletRecord &applet = applets[appletKey];
+
+        if (group.count() == 4) {
+            applet.keys << key;
+        } else {
+            applet.groups << group[4];
+
+            if (group.count() == 5 && group[4] == QLatin1String("Configuration")) {
+                applet.configurationKeys << key;
+            }
+        }
+    }
+
+    report.isValid = true;
+    report.containments = containments;
+
+    for (const auto &cId : containments) {
+        for (const auto &aId : containmentApplets[cId]) {
+            const AppletRecord &applet = applets[cId + QLatin1Char('/') + aId];
+
+            //! same as Storage::appletGroupIsValid
+            bool deprecated = (applet.keys.isEmpty()
+                               && applet.groups.count() == 1
+                               && applet.groups.contains(QStringLiteral("Configuration"))
+                               && applet.configurationKeys.count() == 1
+                               && applet.configurationKeys.contains(QStringLiteral("PreloadWeight")));
+
+            if (deprecated) {
+                report.hasDeprecatedApplets = true;
+            } else {
+                report.applets << aId;
+            }
+        }
+    }
+
+    return report;
+}
+
+}
+}
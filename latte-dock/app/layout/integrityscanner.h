@@ -0,0 +1,79 @@
+/*
+*  Copyright 2020  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LAYOUTINTEGRITYSCANNER_H
+#define LAYOUTINTEGRITYSCANNER_H
+
+// Qt
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+
+namespace Latte {
+namespace Layout {
+
+//! containments and applets ids found in a layout file
+struct IntegrityReport
+{
+    bool isValid{false};
+    //! applet config records that are not used any more were found
+    bool hasDeprecatedApplets{false};
+
+    QStringList containments;
+    //! applets ids that are valid, sorted by their containment
+    QStringList applets;
+
+    bool hasDuplicatedIds() const;
+};
+
+//! Reads the ids of containments and applets from layout files line by line instead
+//! of creating full KConfig trees for them. Results are cached based on the file
+//! modification time and size and it is safe to scan different files from different
+//! threads.
+class IntegrityScanner
+{
+public:
+    static IntegrityScanner *self();
+
+    IntegrityReport scan(const QString &file);
+
+    //! scans the provided files in parallel in order to populate the cache
+    void prefetch(const QStringList &files);
+
+private:
+    IntegrityScanner();
+
+    IntegrityReport parse(const QString &file) const;
+
+private:
+    struct CachedReport {
+        QDateTime lastModified;
+        qint64 size{-1};
+        IntegrityReport report;
+    };
+
+    QMutex m_mutex;
+    QHash<QString, CachedReport> m_reports;
+};
+
+}
+}
+
+#endif
@@ -20,18 +20,22 @@
 #include "storage.h"
 
 // local
+#include "integrityscanner.h"
 #include "../apptypes.h"
+#include "../idsallocator.h"
 #include "../lattecorona.h"
 #include "../screenpool.h"
 #include "../layouts/manager.h"
 #include "../layouts/importer.h"
 #include "../view/view.h"
+
 // Qt
-#include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QSet>
 
 // KDE
+#include <KConfig>
 #include <KConfigGroup>
 #include <KSharedConfig>
 
@@ -110,42 +114,20 @@ void Storage::importToCorona()
     //! Setting mutable for create a containment
     m_layout->corona()->setImmutability(Plasma::Types::Mutable);
 
-    QString temp1FilePath = QDir::homePath() + "/.config/lattedock.copy1.bak";
-    //! we need to copy first the layout file because the kde cache
-    //! may not have yet been updated (KSharedConfigPtr)
-    //! this way we make sure at the latest changes stored in the layout file
-    //! will be also available when changing to Multiple Layouts
-    QString tempLayoutFilePath = QDir::homePath() + "/.config/lattedock.layout.bak";
-
-    //! WE NEED A WAY TO COPY A CONTAINMENT!!!!
-    QFile tempLayoutFile(tempLayoutFilePath);
-    QFile copyFile(temp1FilePath);
-    QFile layoutOriginalFile(m_layout->file());
-
-    if (tempLayoutFile.exists()) {
-        tempLayoutFile.remove();
-    }
-
-    if (copyFile.exists())
-        copyFile.remove();
-
-    layoutOriginalFile.copy(tempLayoutFilePath);
-
-    KSharedConfigPtr filePtr = KSharedConfig::openConfig(tempLayoutFilePath);
-    KSharedConfigPtr newFile = KSharedConfig::openConfig(temp1FilePath);
-    KConfigGroup copyGroup = KConfigGroup(newFile, "Containments");
-    KConfigGroup current_containments = KConfigGroup(filePtr, "Containments");
-
-    current_containments.copyTo(&copyGroup);
-
-    copyGroup.sync();
-
-    //! update ids to unique ones
-    QString temp2File = newUniqueIdsLayoutFromFile(temp1FilePath);
+    //! a private KConfig is used instead of the shared one because the kde cache
+    //! may not have yet been updated (KSharedConfigPtr), this way we make sure
+    //! that the latest changes stored in the layout file will be also available
+    //! when changing to Multiple Layouts
+    KConfig layoutFile(m_layout->file(), KConfig::SimpleConfig);
+    KConfigGroup current_containments = KConfigGroup(&layoutFile, "Containments");
 
+    //! update ids to unique ones in memory
+    KConfig fixedLayout(QString(), KConfig::SimpleConfig);
+    KConfigGroup fixedContainments = KConfigGroup(&fixedLayout, "Containments");
+    newUniqueIdsContainments(current_containments, fixedContainments);
 
     //! Finally import the configuration
-    importLayoutFile(temp2File);
+    importLayout(KConfigGroup(&fixedLayout, ""));
 }
 
 void Storage::syncToLayoutFile(bool removeLayoutId)
@@ -187,16 +169,9 @@ void Storage::copyView(Plasma::Containment *containment)
     //! Setting mutable for create a containment
     m_layout->corona()->setImmutability(Plasma::Types::Mutable);
 
-    QString temp1File = QDir::homePath() + "/.config/lattedock.copy1.bak";
-
-    //! WE NEED A WAY TO COPY A CONTAINMENT!!!!
-    QFile copyFile(temp1File);
-
-    if (copyFile.exists())
-        copyFile.remove();
-
-    KSharedConfigPtr newFile = KSharedConfig::openConfig(temp1File);
-    KConfigGroup copied_conts = KConfigGroup(newFile, "Containments");
+    //! containments are copied in memory, no temp files are involved
+    KConfig copiedLayout(QString(), KConfig::SimpleConfig);
+    KConfigGroup copied_conts = KConfigGroup(&copiedLayout, "Containments");
     KConfigGroup copied_c1 = KConfigGroup(&copied_conts, QString::number(containment->id()));
 
     containment->config().copyTo(&copied_c1);
@@ -238,14 +213,15 @@ void Storage::copyView(Plasma::Containment *containment)
     //! end of systray specific code
 
     //! update ids to unique ones
-    QString temp2File = newUniqueIdsLayoutFromFile(temp1File);
-
+    KConfig fixedLayout(QString(), KConfig::SimpleConfig);
+    KConfigGroup fixedContainments = KConfigGroup(&fixedLayout, "Containments");
+    newUniqueIdsContainments(copied_conts, fixedContainments);
 
     //! Don't create LatteView when the containment is created because we must update
     //! its screen settings first
     m_layout->setBlockAutomaticLatteViewCreation(true);
     //! Finally import the configuration
-    QList<Plasma::Containment *> importedDocks = importLayoutFile(temp2File);
+    QList<Plasma::Containment *> importedDocks = importLayout(KConfigGroup(&fixedLayout, ""));
 
     Plasma::Containment *newContainment{nullptr};
 
@@ -324,10 +300,9 @@ void Storage::copyView(Plasma::Containment *containment)
     m_layout->setBlockAutomaticLatteViewCreation(false);
 }
 
-QList<Plasma::Containment *> Storage::importLayoutFile(QString file)
+QList<Plasma::Containment *> Storage::importLayout(const KConfigGroup &layout)
 {
-    KSharedConfigPtr filePtr = KSharedConfig::openConfig(file);
-    auto newContainments = m_layout->corona()->importLayout(KConfigGroup(filePtr, ""));
+    auto newContainments = m_layout->corona()->importLayout(layout);
 
     ///Find latte and systray containments
     qDebug() << " imported containments ::: " << newContainments.length();
@@ -437,43 +412,14 @@ QList<int> Storage::viewsScreens()
     return screens;
 }
 
-QString Storage::availableId(QStringList all, QStringList assigned, int base)
-{
-    bool found = false;
-
-    int i = base;
-
-    while (!found && i < 32000) {
-        QString iStr = QString::number(i);
-
-        if (!all.contains(iStr) && !assigned.contains(iStr)) {
-            return iStr;
-        }
-
-        i++;
-    }
-
-    return QString("");
-}
-
-QString Storage::newUniqueIdsLayoutFromFile(QString file)
+void Storage::newUniqueIdsContainments(const KConfigGroup &investigate_conts, KConfigGroup &fixedNewContainmets)
 {
     if (!m_layout->corona()) {
-        return QString();
-    }
-
-    QString tempFile = QDir::homePath() + "/.config/lattedock.copy2.bak";
-
-    QFile copyFile(tempFile);
-
-    if (copyFile.exists()) {
-        copyFile.remove();
+        return;
     }
 
-    //! BEGIN updating the ids in the temp file
-    QStringList allIds;
-    allIds << m_layout->corona()->containmentsIds();
-    allIds << m_layout->corona()->appletsIds();
+    //! BEGIN updating the ids
+    IdsAllocator *idsAllocator = m_layout->corona()->idsAllocator();
 
     QStringList toInvestigateContainmentIds;
     QStringList toInvestigateAppletIds;
@@ -483,17 +429,12 @@ QString Storage::newUniqueIdsLayoutFromFile(QString file)
     QHash<QString, QString> systrayParentContainmentIds;
     QHash<QString, QString> systrayAppletIds;
 
-    //qDebug() << "Ids:" << allIds;
-
     //qDebug() << "to copy containments: " << toCopyContainmentIds;
     //qDebug() << "to copy applets: " << toCopyAppletIds;
 
-    QStringList assignedIds;
+    QSet<uint> assignedIds;
     QHash<QString, QString> assigned;
 
-    KSharedConfigPtr filePtr = KSharedConfig::openConfig(file);
-    KConfigGroup investigate_conts = KConfigGroup(filePtr, "Containments");
-
     //! Record the containment and applet ids
     for (const auto &cId : investigate_conts.groupList()) {
         toInvestigateContainmentIds << cId;
@@ -517,22 +458,19 @@ QString Storage::newUniqueIdsLayoutFromFile(QString file)
         }
     }
 
-    //! Reassign containment and applet ids to unique ones
-    for (const auto &contId : toInvestigateContainmentIds) {
-        QString newId = availableId(allIds, assignedIds, 12);
+    //! Reassign containment and applet ids to unique ones, allocation continues
+    //! from the last assigned id so each search is done only once
+    uint containmentsBase{12};
+    uint appletsBase{40};
 
-        assignedIds << newId;
-        assigned[contId] = newId;
+    for (const auto &contId : toInvestigateContainmentIds) {
+        assigned[contId] = QString::number(idsAllocator->allocate(containmentsBase, assignedIds));
     }
 
     for (const auto &appId : toInvestigateAppletIds) {
-        QString newId = availableId(allIds, assignedIds, 40);
-
-        assignedIds << newId;
-        assigned[appId] = newId;
+        assigned[appId] = QString::number(idsAllocator->allocate(appletsBase, assignedIds));
     }
 
-    qDebug() << "ALL CORONA IDS ::: " << allIds;
     qDebug() << "FULL ASSIGNMENTS ::: " << assigned;
 
     for (const auto &cId : toInvestigateContainmentIds) {
@@ -565,15 +503,33 @@ QString Storage::newUniqueIdsLayoutFromFile(QString file)
 
     qDebug() << "FIXED FULL ASSIGNMENTS ::: " << assigned;
 
+    //! Copy containments and applets under their new ids
+    for (const auto &contId : investigate_conts.groupList()) {
+        QString pluginId = investigate_conts.group(contId).readEntry("plugin", "");
+
+        if (pluginId != "org.kde.desktopcontainment") { //!don't add ghost containments
+            KConfigGroup newContainmentGroup = fixedNewContainmets.group(assigned[contId]);
+            investigate_conts.group(contId).copyTo(&newContainmentGroup);
+
+            newContainmentGroup.group("Applets").deleteGroup();
+
+            for (const auto &appId : investigate_conts.group(contId).group("Applets").groupList()) {
+                KConfigGroup appletGroup = investigate_conts.group(contId).group("Applets").group(appId);
+                KConfigGroup newAppletGroup = fixedNewContainmets.group(assigned[contId]).group("Applets").group(assigned[appId]);
+                appletGroup.copyTo(&newAppletGroup);
+            }
+        }
+    }
+
     //! update applet ids in their containment order and in MultipleLayouts update also the layoutId
-    for (const auto &cId : investigate_conts.groupList()) {
+    for (const auto &cId : fixedNewContainmets.groupList()) {
         //! Update options that contain applet ids
         //! (appletOrder) and (lockedZoomApplets) and (userBlocksColorizingApplets)
         QStringList options;
         options << "appletOrder" << "lockedZoomApplets" << "userBlocksColorizingApplets";
 
         for (const auto &settingStr : options) {
-            QString order1 = investigate_conts.group(cId).group("General").readEntry(settingStr, QString());
+            QString order1 = fixedNewContainmets.group(cId).group("General").readEntry(settingStr, QString());
 
             if (!order1.isEmpty()) {
                 QStringList order1Ids = order1.split(";");
@@ -584,50 +540,29 @@ QString Storage::newUniqueIdsLayoutFromFile(QString file)
                 }
 
                 QString fixedOrder1 = fixedOrder1Ids.join(";");
-                investigate_conts.group(cId).group("General").writeEntry(settingStr, fixedOrder1);
+                fixedNewContainmets.group(cId).group("General").writeEntry(settingStr, fixedOrder1);
             }
         }
 
         if (m_layout->corona()->layoutsManager()->memoryUsage() == MemoryUsage::MultipleLayouts) {
-            investigate_conts.group(cId).writeEntry("layoutId", m_layout->name());
+            fixedNewContainmets.group(cId).writeEntry("layoutId", m_layout->name());
         }
     }
 
     //! must update also the systray id in its applet
     for (const auto &systrayId : toInvestigateSystrayContIds) {
-        KConfigGroup systrayParentContainment = investigate_conts.group(systrayParentContainmentIds[systrayId]);
-        systrayParentContainment.group("Applets").group(systrayAppletIds[systrayId]).group("Configuration").writeEntry("SystrayContainmentId", assigned[systrayId]);
-        systrayParentContainment.sync();
-    }
-
-    investigate_conts.sync();
-
-    //! Copy To Temp 2 File And Update Correctly The Ids
-    KSharedConfigPtr file2Ptr = KSharedConfig::openConfig(tempFile);
-    KConfigGroup fixedNewContainmets = KConfigGroup(file2Ptr, "Containments");
-
-    for (const auto &contId : investigate_conts.groupList()) {
-        QString pluginId = investigate_conts.group(contId).readEntry("plugin", "");
+        QString parentId = assigned[systrayParentContainmentIds[systrayId]];
 
-        if (pluginId != "org.kde.desktopcontainment") { //!don't add ghost containments
-            KConfigGroup newContainmentGroup = fixedNewContainmets.group(assigned[contId]);
-            investigate_conts.group(contId).copyTo(&newContainmentGroup);
-
-            newContainmentGroup.group("Applets").deleteGroup();
-
-            for (const auto &appId : investigate_conts.group(contId).group("Applets").groupList()) {
-                KConfigGroup appletGroup = investigate_conts.group(contId).group("Applets").group(appId);
-                KConfigGroup newAppletGroup = fixedNewContainmets.group(assigned[contId]).group("Applets").group(assigned[appId]);
-                appletGroup.copyTo(&newAppletGroup);
-            }
+        if (!fixedNewContainmets.hasGroup(parentId)) {
+            continue;
         }
-    }
 
-    fixedNewContainmets.sync();
-
-    return tempFile;
+        KConfigGroup systrayParentContainment = fixedNewContainmets.group(parentId);
+        systrayParentContainment.group("Applets").group(assigned[systrayAppletIds[systrayId]]).group("Configuration").writeEntry("SystrayContainmentId", assigned[systrayId]);
+    }
 }
 
+
 bool Storage::appletGroupIsValid(KConfigGroup appletGroup)
 {
     return !( appletGroup.keyList().count() == 0
@@ -637,6 +572,32 @@ bool Storage::appletGroupIsValid(KConfigGroup appletGroup)
               && appletGroup.group("Configuration").hasKey("PreloadWeight") );
 }
 
+void Storage::removeDeprecatedApplets() const
+{
+    KSharedConfigPtr lFile = KSharedConfig::openConfig(m_layout->file());
+    KConfigGroup containmentsEntries = KConfigGroup(lFile, "Containments");
+
+    for (const auto &cId : containmentsEntries.groupList()) {
+        auto appletsEntries = containmentsEntries.group(cId).group("Applets");
+        bool updated{false};
+
+        for (const auto &appletId : appletsEntries.groupList()) {
+            KConfigGroup appletGroup = appletsEntries.group(appletId);
+
+            if (!appletGroupIsValid(appletGroup)) {
+                updated = true;
+                //! heal layout file by removing applet config records that are not used any more
+                qDebug() << "Layout: " << m_layout->name() << " removing deprecated applet : " << appletId;
+                appletsEntries.deleteGroup(appletId);
+            }
+        }
+
+        if (updated) {
+            appletsEntries.sync();
+        }
+    }
+}
+
 bool Storage::layoutIsBroken(QStringList &errors) const
 {
     if (m_layout->file().isEmpty() || !QFile(m_layout->file()).exists()) {
@@ -647,39 +608,17 @@ bool Storage::layoutIsBroken(QStringList &errors) const
     QStringList conts;
     QStringList applets;
 
-    KSharedConfigPtr lFile = KSharedConfig::openConfig(m_layout->file());
-
     if (!m_layout->corona()) {
-        KConfigGroup containmentsEntries = KConfigGroup(lFile, "Containments");
-        ids << containmentsEntries.groupList();
-        conts << ids;
-
-        for (const auto &cId : containmentsEntries.groupList()) {
-            auto appletsEntries = containmentsEntries.group(cId).group("Applets");
-
-            QStringList validAppletIds;
-            bool updated{false};
-
-            for (const auto &appletId : appletsEntries.groupList()) {
-                KConfigGroup appletGroup = appletsEntries.group(appletId);
-
-                if (appletGroupIsValid(appletGroup)) {
-                    validAppletIds << appletId;
-                } else {
-                    updated = true;
-                    //! heal layout file by removing applet config records that are not used any more
-                    qDebug() << "Layout: " << m_layout->name() << " removing deprecated applet : " << appletId;
-                    appletsEntries.deleteGroup(appletId);
-                }
-            }
+        IntegrityReport report = IntegrityScanner::self()->scan(m_layout->file());
 
-            if (updated) {
-                appletsEntries.sync();
-            }
-
-            ids << validAppletIds;
-            applets << validAppletIds;
+        if (report.hasDeprecatedApplets) {
+            removeDeprecatedApplets();
         }
+
+        ids << report.containments;
+        conts << report.containments;
+        ids << report.applets;
+        applets << report.applets;
     } else {
         for (const auto containment : *m_layout->containments()) {
             ids << QString::number(containment->id());
@@ -741,6 +680,7 @@ bool Storage::layoutIsBroken(QStringList &errors) const
         qDebug() << "  -- - -- - -- - -- - - -- - - - - -- - - - - ";
 
         if (!m_layout->corona()) {
+            KSharedConfigPtr lFile = KSharedConfig::openConfig(m_layout->file());
             KConfigGroup containmentsEntries = KConfigGroup(lFile, "Containments");
 
             for (const auto &cId : containmentsEntries.groupList()) {
@@ -66,13 +66,14 @@ public:
 
 private:
     //! STORAGE !////
-    QString availableId(QStringList all, QStringList assigned, int base);
-    //! provides a new file path based the provided file. The new file
-    //! has updated ids for containments and applets based on the corona
+    //! copies the provided containments into destination group in memory. The copied
+    //! containments have updated ids for containments and applets based on the corona
     //! loaded ones
-    QString newUniqueIdsLayoutFromFile(QString file);
-    //! imports a layout file and returns the containments for the docks
-    QList<Plasma::Containment *> importLayoutFile(QString file);
+    void newUniqueIdsContainments(const KConfigGroup &containments, KConfigGroup &destination);
+    //! removes applet config records from layout file that are not used any more
+    void removeDeprecatedApplets() const;
+    //! imports a layout and returns the containments for the docks
+    QList<Plasma::Containment *> importLayout(const KConfigGroup &layout);
 
 private:
     GenericLayout *m_layout;
@@ -27,9 +27,6 @@
 #include "../layouts/manager.h"
 #include "../layouts/synchronizer.h"
 
-// Qt
-#include <QQuickItem>
-
 // Plasma
 #include <Plasma/Applet>
 #include <Plasma/Containment>
@@ -48,67 +45,104 @@ LaunchersSignals::~LaunchersSignals()
 {
 }
 
-QList<Plasma::Applet *> LaunchersSignals::lattePlasmoids(QString layoutName)
+void LaunchersSignals::registerTasks(uint appletId, QQuickItem *tasks)
 {
-    QList<Plasma::Applet *> applets;
+    if (!tasks) {
+        return;
+    }
 
-    CentralLayout *layout = m_manager->synchronizer()->centralLayout(layoutName);
-    QList<Plasma::Containment *> containments;
+    Plasma::Containment *containment = containmentOfApplet(appletId);
 
-    if (layoutName.isEmpty()) {
-        containments = m_manager->corona()->containments();
-    } else if (layout) {
-        containments = *(layout->containments());
+    if (!containment) {
+        return;
     }
 
-    for(const auto containment : containments) {
-        for(auto *applet : containment->applets()) {
-            KPluginMetaData meta = applet->kPackage().metadata();
+    unregisterTasks(appletId);
 
-            if (meta.pluginId() == "org.kde.latte.plasmoid") {
-                applets.append(applet);
-            }
-        }
+    const QMetaObject *metaObject = tasks->metaObject();
+
+    auto method = [metaObject](const char *signature) {
+        int methodIndex = metaObject->indexOfMethod(signature);
+        return methodIndex >= 0 ? metaObject->method(methodIndex) : QMetaMethod();
+    };
+
+    TasksEndpoint endpoint;
+    endpoint.appletId = appletId;
+    endpoint.tasks = tasks;
+
+    endpoint.addLauncher = method("extSignalAddLauncher(QVariant,QVariant)");
+    endpoint.removeLauncher = method("extSignalRemoveLauncher(QVariant,QVariant)");
+    endpoint.addLauncherToActivity = method("extSignalAddLauncherToActivity(QVariant,QVariant,QVariant)");
+    endpoint.removeLauncherFromActivity = method("extSignalRemoveLauncherFromActivity(QVariant,QVariant,QVariant)");
+    endpoint.urlsDropped = method("extSignalUrlsDropped(QVariant,QVariant)");
+    endpoint.moveTask = method("extSignalMoveTask(QVariant,QVariant,QVariant)");
+    endpoint.validateLaunchersOrder = method("extSignalValidateLaunchersOrder(QVariant,QVariant)");
+
+    if (!m_endpoints.contains(containment)) {
+        connect(containment, &QObject::destroyed, this, [this, containment]() {
+            m_endpoints.remove(containment);
+        });
     }
 
-    return applets;
+    m_endpoints[containment] << endpoint;
+
+    connect(tasks, &QObject::destroyed, this, [this, appletId]() {
+        unregisterTasks(appletId);
+    });
 }
 
-void LaunchersSignals::addLauncher(QString layoutName, int launcherGroup, QString launcher)
+void LaunchersSignals::unregisterTasks(uint appletId)
 {
-    Types::LaunchersGroup group = static_cast<Types::LaunchersGroup>(launcherGroup);
+    for (auto it = m_endpoints.begin(); it != m_endpoints.end(); ++it) {
+        for (int i = 0; i < it.value().count(); ++i) {
+            if (it.value()[i].appletId == appletId) {
+                if (it.value()[i].tasks) {
+                    disconnect(it.value()[i].tasks, &QObject::destroyed, this, nullptr);
+                }
 
-    if ((Types::LaunchersGroup)group == Types::UniqueLaunchers) {
-        return;
-    }
+                it.value().removeAt(i);
 
-    QString lName = (group == Types::LayoutLaunchers) ? layoutName : "";
+                if (it.value().isEmpty()) {
+                    m_endpoints.erase(it);
+                }
 
-    for(const auto applet : lattePlasmoids(lName)) {
-        if (QQuickItem *appletInterface = applet->property("_plasma_graphicObject").value<QQuickItem *>()) {
-            const auto &childItems = appletInterface->childItems();
+                return;
+            }
+        }
+    }
+}
 
-            if (childItems.isEmpty()) {
-                continue;
+Plasma::Containment *LaunchersSignals::containmentOfApplet(uint appletId) const
+{
+    for (const auto containment : m_manager->corona()->containments()) {
+        for (const auto applet : containment->applets()) {
+            if (applet->id() == appletId) {
+                return containment;
             }
+        }
+    }
 
-            for (QQuickItem *item : childItems) {
-                if (auto *metaObject = item->metaObject()) {
-                    int methodIndex = metaObject->indexOfMethod("extSignalAddLauncher(QVariant,QVariant)");
+    return nullptr;
+}
 
-                    if (methodIndex == -1) {
-                        continue;
-                    }
+QList<LaunchersSignals::TasksEndpoint> LaunchersSignals::endpoints(QString layoutName) const
+{
+    QList<TasksEndpoint> result;
 
-                    QMetaMethod method = metaObject->method(methodIndex);
-                    method.invoke(item, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, launcher));
-                }
-            }
+    if (layoutName.isEmpty()) {
+        for (const auto &containmentEndpoints : m_endpoints) {
+            result << containmentEndpoints;
+        }
+    } else if (CentralLayout *layout = m_manager->synchronizer()->centralLayout(layoutName)) {
+        for (const auto containment : *(layout->containments())) {
+            result << m_endpoints.value(containment);
         }
     }
+
+    return result;
 }
 
-void LaunchersSignals::removeLauncher(QString layoutName, int launcherGroup, QString launcher)
+void LaunchersSignals::addLauncher(QString layoutName, int launcherGroup, QString launcher)
 {
     Types::LaunchersGroup group = static_cast<Types::LaunchersGroup>(launcherGroup);
 
@@ -118,26 +152,26 @@ void LaunchersSignals::removeLauncher(QString layoutName, int launcherGroup, QSt
 
     QString lName = (group == Types::LayoutLaunchers) ? layoutName : "";
 
-    for(const auto applet : lattePlasmoids(lName)) {
-        if (QQuickItem *appletInterface = applet->property("_plasma_graphicObject").value<QQuickItem *>()) {
-            const auto &childItems = appletInterface->childItems();
+    for(const auto &endpoint : endpoints(lName)) {
+        if (endpoint.tasks && endpoint.addLauncher.isValid()) {
+            endpoint.addLauncher.invoke(endpoint.tasks, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, launcher));
+        }
+    }
+}
 
-            if (childItems.isEmpty()) {
-                continue;
-            }
+void LaunchersSignals::removeLauncher(QString layoutName, int launcherGroup, QString launcher)
+{
+    Types::LaunchersGroup group = static_cast<Types::LaunchersGroup>(launcherGroup);
 
-            for (QQuickItem *item : childItems) {
-                if (auto *metaObject = item->metaObject()) {
-                    int methodIndex = metaObject->indexOfMethod("extSignalRemoveLauncher(QVariant,QVariant)");
+    if ((Types::LaunchersGroup)group == Types::UniqueLaunchers) {
+        return;
+    }
 
-                    if (methodIndex == -1) {
-                        continue;
-                    }
+    QString lName = (group == Types::LayoutLaunchers) ? layoutName : "";
 
-                    QMetaMethod method = metaObject->method(methodIndex);
-                    method.invoke(item, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, launcher));
-                }
-            }
+    for(const auto &endpoint : endpoints(lName)) {
+        if (endpoint.tasks && endpoint.removeLauncher.isValid()) {
+            endpoint.removeLauncher.invoke(endpoint.tasks, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, launcher));
         }
     }
 }
@@ -152,26 +186,9 @@ void LaunchersSignals::addLauncherToActivity(QString layoutName, int launcherGro
 
     QString lName = (group == Types::LayoutLaunchers) ? layoutName : "";
 
-    for(const auto applet : lattePlasmoids(lName)) {
-        if (QQuickItem *appletInterface = applet->property("_plasma_graphicObject").value<QQuickItem *>()) {
-            const auto &childItems = appletInterface->childItems();
-
-            if (childItems.isEmpty()) {
-                continue;
-            }
-
-            for (QQuickItem *item : childItems) {
-                if (auto *metaObject = item->metaObject()) {
-                    int methodIndex = metaObject->indexOfMethod("extSignalAddLauncherToActivity(QVariant,QVariant,QVariant)");
-
-                    if (methodIndex == -1) {
-                        continue;
-                    }
-
-                    QMetaMethod method = metaObject->method(methodIndex);
-                    method.invoke(item, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, launcher), Q_ARG(QVariant, activity));
-                }
-            }
+    for(const auto &endpoint : endpoints(lName)) {
+        if (endpoint.tasks && endpoint.addLauncherToActivity.isValid()) {
+            endpoint.addLauncherToActivity.invoke(endpoint.tasks, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, launcher), Q_ARG(QVariant, activity));
         }
     }
 }
@@ -186,26 +203,9 @@ void LaunchersSignals::removeLauncherFromActivity(QString layoutName, int launch
 
     QString lName = (group == Types::LayoutLaunchers) ? layoutName : "";
 
-    for(const auto applet : lattePlasmoids(lName)) {
-        if (QQuickItem *appletInterface = applet->property("_plasma_graphicObject").value<QQuickItem *>()) {
-            const auto &childItems = appletInterface->childItems();
-
-            if (childItems.isEmpty()) {
-                continue;
-            }
-
-            for (QQuickItem *item : childItems) {
-                if (auto *metaObject = item->metaObject()) {
-                    int methodIndex = metaObject->indexOfMethod("extSignalRemoveLauncherFromActivity(QVariant,QVariant,QVariant)");
-
-                    if (methodIndex == -1) {
-                        continue;
-                    }
-
-                    QMetaMethod method = metaObject->method(methodIndex);
-                    method.invoke(item, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, launcher), Q_ARG(QVariant, activity));
-                }
-            }
+    for(const auto &endpoint : endpoints(lName)) {
+        if (endpoint.tasks && endpoint.removeLauncherFromActivity.isValid()) {
+            endpoint.removeLauncherFromActivity.invoke(endpoint.tasks, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, launcher), Q_ARG(QVariant, activity));
         }
     }
 }
@@ -220,26 +220,9 @@ void LaunchersSignals::urlsDropped(QString layoutName, int launcherGroup, QStrin
 
     QString lName = (group == Types::LayoutLaunchers) ? layoutName : "";
 
-    for(const auto applet : lattePlasmoids(lName)) {
-        if (QQuickItem *appletInterface = applet->property("_plasma_graphicObject").value<QQuickItem *>()) {
-            const auto &childItems = appletInterface->childItems();
-
-            if (childItems.isEmpty()) {
-                continue;
-            }
-
-            for (QQuickItem *item : childItems) {
-                if (auto *metaObject = item->metaObject()) {
-                    int methodIndex = metaObject->indexOfMethod("extSignalUrlsDropped(QVariant,QVariant)");
-
-                    if (methodIndex == -1) {
-                        continue;
-                    }
-
-                    QMetaMethod method = metaObject->method(methodIndex);
-                    method.invoke(item, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, urls));
-                }
-            }
+    for(const auto &endpoint : endpoints(lName)) {
+        if (endpoint.tasks && endpoint.urlsDropped.isValid()) {
+            endpoint.urlsDropped.invoke(endpoint.tasks, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, urls));
         }
     }
 }
@@ -254,28 +237,9 @@ void LaunchersSignals::moveTask(QString layoutName, uint senderId, int launcherG
 
     QString lName = (group == Types::LayoutLaunchers) ? layoutName : "";
 
-    for(const auto applet : lattePlasmoids(lName)) {
-        if (applet->id() != senderId) {
-            if (QQuickItem *appletInterface = applet->property("_plasma_graphicObject").value<QQuickItem *>()) {
-                const auto &childItems = appletInterface->childItems();
-
-                if (childItems.isEmpty()) {
-                    continue;
-                }
-
-                for (QQuickItem *item : childItems) {
-                    if (auto *metaObject = item->metaObject()) {
-                        int methodIndex = metaObject->indexOfMethod("extSignalMoveTask(QVariant,QVariant,QVariant)");
-
-                        if (methodIndex == -1) {
-                            continue;
-                        }
-
-                        QMetaMethod method = metaObject->method(methodIndex);
-                        method.invoke(item, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, from), Q_ARG(QVariant, to));
-                    }
-                }
-            }
+    for(const auto &endpoint : endpoints(lName)) {
+        if (endpoint.tasks && endpoint.appletId != senderId && endpoint.moveTask.isValid()) {
+            endpoint.moveTask.invoke(endpoint.tasks, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, from), Q_ARG(QVariant, to));
         }
     }
 }
@@ -290,28 +254,9 @@ void LaunchersSignals::validateLaunchersOrder(QString layoutName, uint senderId,
 
     QString lName = (group == Types::LayoutLaunchers) ? layoutName : "";
 
-    for(const auto applet : lattePlasmoids(lName)) {
-        if (applet->id() != senderId) {
-            if (QQuickItem *appletInterface = applet->property("_plasma_graphicObject").value<QQuickItem *>()) {
-                const auto &childItems = appletInterface->childItems();
-
-                if (childItems.isEmpty()) {
-                    continue;
-                }
-
-                for (QQuickItem *item : childItems) {
-                    if (auto *metaObject = item->metaObject()) {
-                        int methodIndex = metaObject->indexOfMethod("extSignalValidateLaunchersOrder(QVariant,QVariant)");
-
-                        if (methodIndex == -1) {
-                            continue;
-                        }
-
-                        QMetaMethod method = metaObject->method(methodIndex);
-                        method.invoke(item, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, launchers));
-                    }
-                }
-            }
+    for(const auto &endpoint : endpoints(lName)) {
+        if (endpoint.tasks && endpoint.appletId != senderId && endpoint.validateLaunchersOrder.isValid()) {
+            endpoint.validateLaunchersOrder.invoke(endpoint.tasks, Q_ARG(QVariant, launcherGroup), Q_ARG(QVariant, launchers));
         }
     }
 }
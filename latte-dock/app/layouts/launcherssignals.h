@@ -22,10 +22,15 @@
 #define LAUNCHERSSIGNALS_H
 
 // Qt
+#include <QHash>
+#include <QList>
+#include <QMetaMethod>
 #include <QObject>
+#include <QPointer>
+#include <QQuickItem>
 
 namespace Plasma {
-class Applet;
+class Containment;
 }
 
 namespace Latte {
@@ -43,6 +48,8 @@ namespace Layouts {
 //! crashes that occur by setting the launcherList of the tasksModel so
 //! often. The plasma devs of libtaskmanager have designed the launchers
 //! model to be initialized only once during startup
+//! Latte tasks plasmoids register themselves once, together with their
+//! external signals methods, so broadcasts do not need to search for them
 class LaunchersSignals : public QObject
 {
     Q_OBJECT
@@ -52,6 +59,9 @@ public:
     ~LaunchersSignals() override;
 
 public slots:
+    Q_INVOKABLE void registerTasks(uint appletId, QQuickItem *tasks);
+    Q_INVOKABLE void unregisterTasks(uint appletId);
+
     Q_INVOKABLE void addLauncher(QString layoutName, int launcherGroup, QString launcher);
     Q_INVOKABLE void removeLauncher(QString layoutName, int launcherGroup, QString launcher);
     Q_INVOKABLE void addLauncherToActivity(QString layoutName, int launcherGroup, QString launcher, QString activity);
@@ -62,10 +72,29 @@ public slots:
     Q_INVOKABLE void validateLaunchersOrder(QString layoutName, uint senderId, int launcherGroup, QStringList launchers);
 
 private:
-    QList<Plasma::Applet *> lattePlasmoids(QString layoutName);
+    struct TasksEndpoint {
+        uint appletId{0};
+        QPointer<QQuickItem> tasks;
+
+        QMetaMethod addLauncher;
+        QMetaMethod removeLauncher;
+        QMetaMethod addLauncherToActivity;
+        QMetaMethod removeLauncherFromActivity;
+        QMetaMethod urlsDropped;
+        QMetaMethod moveTask;
+        QMetaMethod validateLaunchersOrder;
+    };
+
+    //! registered tasks plasmoids of the layout, all of them when layoutName is empty
+    QList<TasksEndpoint> endpoints(QString layoutName) const;
+
+    Plasma::Containment *containmentOfApplet(uint appletId) const;
 
 private:
     Layouts::Manager *m_manager{nullptr};
+
+    //! registered tasks plasmoids grouped by their containment
+    QHash<const Plasma::Containment *, QList<TasksEndpoint>> m_endpoints;
 };
 
 }
@@ -41,6 +41,8 @@
 #include <KActivities/Consumer>
 #include <KActivities/Controller>
 
+#define WARMLAYOUTSINTERVAL 3000
+
 namespace Latte {
 namespace Layouts {
 
@@ -56,6 +58,17 @@ Synchronizer::Synchronizer(QObject *parent)
     connect(m_manager->corona()->universalSettings(), &UniversalSettings::showInfoWindowChanged, this, &Synchronizer::updateDynamicSwitchInterval);
     connect(&m_dynamicSwitchTimer, &QTimer::timeout, this, &Synchronizer::confirmDynamicSwitch);
 
+    //! Warm Layouts are preloaded in the background
+    m_warmLayoutsTimer.setSingleShot(true);
+    m_warmLayoutsTimer.setInterval(WARMLAYOUTSINTERVAL);
+    connect(&m_warmLayoutsTimer, &QTimer::timeout, this, &Synchronizer::preloadWarmLayouts);
+    connect(m_manager->corona()->universalSettings(), &UniversalSettings::warmLayoutsChanged, this, [&]() {
+        m_warmLayoutsTimer.start();
+    });
+    connect(m_manager->corona()->universalSettings(), &UniversalSettings::warmLayoutsMemoryBudgetChanged, this, [&]() {
+        m_warmLayoutsTimer.start();
+    });
+
     //! KActivities tracking
     connect(m_manager->corona()->activitiesConsumer(), &KActivities::Consumer::currentActivityChanged,
             this, &Synchronizer::currentActivityChanged);
@@ -80,7 +93,7 @@ KActivities::Controller *Synchronizer::activitiesController() const
 
 bool Synchronizer::latteViewExists(Latte::View *view) const
 {
-    for (const auto layout : m_centralLayouts) {
+    for (const auto layout : m_centralLayouts + m_warmLayouts) {
         for (const auto &v : layout->latteViews()) {
             if (v == view) {
                 return true;
@@ -353,6 +366,17 @@ Layout::GenericLayout *Synchronizer::layout(QString id) const
     return l;
 }
 
+CentralLayout *Synchronizer::warmLayout(QString id) const
+{
+    for (const auto layout : m_warmLayouts) {
+        if (layout->name() == id) {
+            return layout;
+        }
+    }
+
+    return nullptr;
+}
+
 SharedLayout *Synchronizer::sharedLayout(QString id) const
 {
     for (int i = 0; i < m_sharedLayouts.size(); ++i) {
@@ -368,7 +392,7 @@ SharedLayout *Synchronizer::sharedLayout(QString id) const
 
 Latte::View *Synchronizer::viewForContainment(Plasma::Containment *containment)
 {
-    for (auto layout : m_centralLayouts) {
+    for (auto layout : m_centralLayouts + m_warmLayouts) {
         Latte::View *view = layout->viewForContainment(containment);
 
         if (view) {
@@ -392,6 +416,8 @@ void Synchronizer::addLayout(CentralLayout *layout)
     if (!m_centralLayouts.contains(layout)) {
         m_centralLayouts.append(layout);
         layout->initToCorona(m_manager->corona());
+
+        connect(layout, &Layout::AbstractLayout::lastUsedActivityChanged, this, &Synchronizer::updateLayoutsHistory, Qt::UniqueConnection);
     }
 }
 
@@ -548,9 +574,220 @@ void Synchronizer::unloadSharedLayout(SharedLayout *layout)
     }
 }
 
+bool Synchronizer::canBeWarmLayout(CentralLayout *layout) const
+{
+    //! layouts for free activities are always visible and shared layouts
+    //! are bound to their central ones, so they can not be kept warm
+    return layout
+            && m_manager->memoryUsage() == MemoryUsage::MultipleLayouts
+            && m_multipleModeInitialized
+            && m_manager->corona()->universalSettings()->warmLayouts() > 0
+            && !layout->activities().isEmpty()
+            && layout->sharedLayoutName().isEmpty()
+            && !m_sharedLayoutIds.contains(layout->name());
+}
+
+bool Synchronizer::warmLayoutsMemoryBudgetExceeded() const
+{
+    int budget = m_manager->corona()->universalSettings()->warmLayoutsMemoryBudget();
+
+    if (budget <= 0) {
+        return false;
+    }
+
+    qint64 memory = residentMemory();
+
+    return (memory >= 0 && memory > (qint64)budget * 1024 * 1024);
+}
+
+qint64 Synchronizer::residentMemory()
+{
+    QFile status(QStringLiteral("/proc/self/status"));
+
+    if (!status.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return -1;
+    }
+
+    //! VmRSS:     123456 kB
+    while (!status.atEnd()) {
+        QByteArray line = status.readLine();
+
+        if (line.startsWith("VmRSS:")) {
+            QList<QByteArray> fields = line.simplified().split(' ');
+            bool ok{false};
+            qint64 kbytes = fields.count() > 1 ? fields[1].toLongLong(&ok) : 0;
+
+            return ok ? kbytes * 1024 : -1;
+        }
+    }
+
+    return -1;
+}
+
+QStringList Synchronizer::warmLayoutsCandidates()
+{
+    QStringList candidates;
+
+    if (m_manager->memoryUsage() != MemoryUsage::MultipleLayouts || !m_multipleModeInitialized) {
+        return candidates;
+    }
+
+    int count = m_manager->corona()->universalSettings()->warmLayouts();
+
+    for (const auto &layoutName : m_layoutsHistory) {
+        if (candidates.count() >= count) {
+            break;
+        }
+
+        if (!m_layouts.contains(layoutName)
+                || !layoutIsAssigned(layoutName)
+                || m_sharedLayoutIds.contains(layoutName)
+                || centralLayout(layoutName)
+                || sharedLayout(layoutName)) {
+            continue;
+        }
+
+        candidates << layoutName;
+    }
+
+    return candidates;
+}
+
+CentralLayout *Synchronizer::takeWarmLayout(const QString &layoutName)
+{
+    CentralLayout *layout = warmLayout(layoutName);
+
+    if (layout) {
+        m_warmLayouts.removeAll(layout);
+    }
+
+    return layout;
+}
+
+void Synchronizer::touchLayoutsHistory(const QString &layoutName)
+{
+    if (layoutName.isEmpty() || (!m_layoutsHistory.isEmpty() && m_layoutsHistory[0] == layoutName)) {
+        return;
+    }
+
+    m_layoutsHistory.removeAll(layoutName);
+    m_layoutsHistory.prepend(layoutName);
+
+    if (m_manager->memoryUsage() == MemoryUsage::MultipleLayouts) {
+        m_warmLayoutsTimer.start();
+    }
+}
+
+void Synchronizer::updateLayoutsHistory()
+{
+    CentralLayout *layout = qobject_cast<CentralLayout *>(sender());
+
+    if (layout && !layout->lastUsedActivity().isEmpty()) {
+        touchLayoutsHistory(layout->name());
+    }
+}
+
+void Synchronizer::parkCentralLayout(CentralLayout *layout)
+{
+    qDebug() << "KEEPING WARM LAYOUT ::::: " << layout->name();
+
+    //! containments stay loaded, only the layout file is updated
+    layout->syncToLayoutFile(false);
+    layout->setIsWarm(true);
+    m_warmLayouts.prepend(layout);
+}
+
+void Synchronizer::unloadWarmLayout(CentralLayout *layout, bool syncToLayoutFile)
+{
+    qDebug() << "REMOVING WARM LAYOUT ::::: " << layout->name();
+    m_warmLayouts.removeAll(layout);
+
+    if (syncToLayoutFile) {
+        layout->syncToLayoutFile(true);
+    }
+
+    layout->unloadContainments();
+    layout->unloadLatteViews();
+    m_manager->clearUnloadedContainmentsFromLinkedFile(layout->unloadedContainmentsIds(), true);
+    delete layout;
+}
+
+void Synchronizer::unloadWarmLayouts(bool syncToLayoutFiles)
+{
+    m_warmLayoutsTimer.stop();
+
+    while (!m_warmLayouts.isEmpty()) {
+        unloadWarmLayout(m_warmLayouts.at(0), syncToLayoutFiles);
+    }
+}
+
+void Synchronizer::trimWarmLayouts()
+{
+    QStringList candidates = warmLayoutsCandidates();
+
+    for (int i = m_warmLayouts.size() - 1; i >= 0; --i) {
+        if (!candidates.contains(m_warmLayouts[i]->name())) {
+            unloadWarmLayout(m_warmLayouts[i]);
+        }
+    }
+
+    //! least likely layouts are evicted first
+    while (!m_warmLayouts.isEmpty() && warmLayoutsMemoryBudgetExceeded()) {
+        CentralLayout *leastLikely{nullptr};
+
+        for (const auto &layoutName : candidates) {
+            for (const auto layout : m_warmLayouts) {
+                if (layout->name() == layoutName) {
+                    leastLikely = layout;
+                }
+            }
+        }
+
+        unloadWarmLayout(leastLikely ? leastLikely : m_warmLayouts.last());
+    }
+}
+
+void Synchronizer::preloadWarmLayouts()
+{
+    trimWarmLayouts();
+
+    if (warmLayoutsMemoryBudgetExceeded()) {
+        return;
+    }
+
+    for (const auto &layoutName : warmLayoutsCandidates()) {
+        if (warmLayout(layoutName)) {
+            continue;
+        }
+
+        CentralLayout *newLayout = new CentralLayout(this, layoutPath(layoutName), layoutName);
+
+        if (!canBeWarmLayout(newLayout)) {
+            delete newLayout;
+            m_layoutsHistory.removeAll(layoutName);
+            continue;
+        }
+
+        //! one layout is preloaded at a time in order to not block the user
+        qDebug() << "PRELOADING WARM LAYOUT ::::: " << layoutName;
+        newLayout->setIsWarm(true);
+        newLayout->initToCorona(m_manager->corona());
+        newLayout->importToCorona();
+        connect(newLayout, &Layout::AbstractLayout::lastUsedActivityChanged, this, &Synchronizer::updateLayoutsHistory, Qt::UniqueConnection);
+        m_warmLayouts.append(newLayout);
+
+        m_warmLayoutsTimer.start();
+        return;
+    }
+}
+
 
 void Synchronizer::loadLayouts()
 {
+    //! layout files may have been changed from the settings window so
+    //! preloaded layouts are outdated
+    unloadWarmLayouts(false);
+
     m_layouts.clear();
     m_menuLayouts.clear();
     m_assignedLayouts.clear();
@@ -560,6 +797,7 @@ void Synchronizer::loadLayouts()
     QStringList filter;
     filter.append(QString("*.layout.latte"));
     QStringList files = layoutDir.entryList(filter, QDir::Files | QDir::NoSymLinks);
+    QStringList usedLayouts;
 
     for (const auto &layout : files) {
         if (layout.contains(Layout::AbstractLayout::MultipleLayoutsName)) {
@@ -578,6 +816,10 @@ void Synchronizer::loadLayouts()
 
         m_layouts.append(centralLayout.name());
 
+        if (!centralLayout.lastUsedActivity().isEmpty()) {
+            usedLayouts << centralLayout.name();
+        }
+
         if (centralLayout.showInMenu()) {
             m_menuLayouts.append(centralLayout.name());
         }
@@ -592,6 +834,19 @@ void Synchronizer::loadLayouts()
     //! Shared Layouts should not be used for Activities->Layouts assignments or published lists
     clearSharedLayoutsFromCentralLists();
 
+    //! layouts that have been used at least once are the ones that can be preloaded
+    for (int i = m_layoutsHistory.size() - 1; i >= 0; --i) {
+        if (!m_layouts.contains(m_layoutsHistory[i])) {
+            m_layoutsHistory.removeAt(i);
+        }
+    }
+
+    for (const auto &layoutName : usedLayouts) {
+        if (!m_layoutsHistory.contains(layoutName)) {
+            m_layoutsHistory << layoutName;
+        }
+    }
+
     emit layoutsChanged();
     emit menuLayoutsChanged();
 }
@@ -599,6 +854,8 @@ void Synchronizer::loadLayouts()
 
 void Synchronizer::unloadLayouts()
 {
+    unloadWarmLayouts();
+
     //! Unload all CentralLayouts
     while (!m_centralLayouts.isEmpty()) {
         CentralLayout *layout = m_centralLayouts.at(0);
@@ -859,9 +1116,14 @@ void Synchronizer::syncMultipleLayoutsToActivities(QString layoutForFreeActiviti
         int posLayout = centralLayoutPos(layoutName);
 
         if (posLayout >= 0) {
-            qDebug() << "REMOVING LAYOUT ::::: " << layoutName;
             m_centralLayouts.removeAt(posLayout);
 
+            if (canBeWarmLayout(layout)) {
+                parkCentralLayout(layout);
+                continue;
+            }
+
+            qDebug() << "REMOVING LAYOUT ::::: " << layoutName;
             layout->syncToLayoutFile(true);
             layout->unloadContainments();
             layout->unloadLatteViews();
@@ -873,16 +1135,23 @@ void Synchronizer::syncMultipleLayoutsToActivities(QString layoutForFreeActiviti
     //! Add needed Layouts based on Activities
     for (const auto &layoutName : layoutsToLoad) {
         if (!centralLayout(layoutName)) {
-            CentralLayout *newLayout = new CentralLayout(this, QString(layoutPath(layoutName)), layoutName);
+            CentralLayout *newLayout = takeWarmLayout(layoutName);
 
             if (newLayout) {
+                //! its containments are already loaded, only its views are created
+                qDebug() << "ACTIVATING WARM LAYOUT ::::: " << layoutName;
+                m_centralLayouts.append(newLayout);
+                newLayout->setIsWarm(false);
+                newLayout->syncLatteViewsToScreens();
+            } else {
+                newLayout = new CentralLayout(this, QString(layoutPath(layoutName)), layoutName);
                 qDebug() << "ACTIVATING LAYOUT ::::: " << layoutName;
                 addLayout(newLayout);
                 newLayout->importToCorona();
+            }
 
-                if (m_manager->corona()->universalSettings()->showInfoWindow()) {
-                    m_manager->showInfoWindow(i18n("Activating layout: <b>%0</b> ...").arg(newLayout->name()), 5000, newLayout->appliedActivities());
-                }
+            if (m_manager->corona()->universalSettings()->showInfoWindow()) {
+                m_manager->showInfoWindow(i18n("Activating layout: <b>%0</b> ...").arg(newLayout->name()), 5000, newLayout->appliedActivities());
             }
         }
     }
@@ -904,6 +1173,8 @@ void Synchronizer::syncMultipleLayoutsToActivities(QString layoutForFreeActiviti
 
     updateCurrentLayoutNameInMultiEnvironment();
     emit centralLayoutsChanged();
+
+    m_warmLayoutsTimer.start();
 }
 
 void Synchronizer::syncActiveShares(SharesMap &sharesMap, QStringList &deprecatedShares)
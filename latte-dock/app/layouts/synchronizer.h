@@ -112,7 +112,9 @@ public:
     CentralLayout *currentLayout() const;
     CentralLayout *centralLayout(QString id) const;
     SharedLayout *sharedLayout(QString id) const;
+    //! active layouts only, warm layouts are provided through warmLayout()
     Layout::GenericLayout *layout(QString id) const;
+    CentralLayout *warmLayout(QString id) const;
 
     KActivities::Controller *activitiesController() const;
 
@@ -132,6 +134,9 @@ private slots:
 
     void currentActivityChanged(const QString &id);
 
+    void preloadWarmLayouts();
+    void updateLayoutsHistory();
+
 private:
     void clearSharedLayoutsFromCentralLists();
 
@@ -139,11 +144,29 @@ private:
     void unloadCentralLayout(CentralLayout *layout);
     void unloadSharedLayout(SharedLayout *layout);
 
+    //! Warm Layouts are CentralLayouts that are not needed by any running activity
+    //! but keep their containments loaded in order to be activated faster. Their
+    //! views are created only when they become active again
+    void parkCentralLayout(CentralLayout *layout);
+    void unloadWarmLayout(CentralLayout *layout, bool syncToLayoutFile = true);
+    void unloadWarmLayouts(bool syncToLayoutFiles = true);
+    void trimWarmLayouts();
+    void touchLayoutsHistory(const QString &layoutName);
+
+    bool canBeWarmLayout(CentralLayout *layout) const;
     bool layoutIsAssigned(QString layoutName);
+    bool warmLayoutsMemoryBudgetExceeded() const;
 
     QString layoutPath(QString layoutName);
 
     QStringList validActivities(QStringList currentList);
+    //! the most likely next layouts that should be kept preloaded
+    QStringList warmLayoutsCandidates();
+
+    CentralLayout *takeWarmLayout(const QString &layoutName);
+
+    //! process resident memory in bytes, -1 when it is not available
+    static qint64 residentMemory();
 
 private:
     bool m_multipleModeInitialized{false};
@@ -154,12 +177,16 @@ private:
     QStringList m_layouts;
     QStringList m_menuLayouts;
     QStringList m_sharedLayoutIds;
+    //! layouts ordered from the most recently used one
+    QStringList m_layoutsHistory;
 
     QHash<const QString, QString> m_assignedLayouts;
 
     QTimer m_dynamicSwitchTimer;
+    QTimer m_warmLayoutsTimer;
 
     QList<CentralLayout *> m_centralLayouts;
+    QList<CentralLayout *> m_warmLayouts;
     QList<SharedLayout *> m_sharedLayouts;
 
     Layouts::Manager *m_manager;
@@ -23,11 +23,24 @@
 #include "../../tools/commontools.h"
 
 // Qt
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
 #include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
 #include <QFileInfo>
+#include <QFutureWatcher>
 #include <QImage>
+#include <QImageReader>
 #include <QList>
+#include <QPointer>
+#include <QRect>
 #include <QRgb>
+#include <QSaveFile>
+#include <QSet>
+#include <QtConcurrent>
 #include <QtMath>
 
 // Plasma
@@ -39,6 +52,16 @@
 
 #define MAXHASHSIZE 300
 
+//! persistent hints cache, it is written lazily after changes
+#define HINTSCACHEFILE "lattedock/backgroundhints"
+#define HINTSCACHEMAGIC 0x4C424748
+#define HINTSCACHEVERSION 1
+#define HINTSCACHESAVEINTERVAL 5000
+
+//! edge band thickness and the maximum band length that is sampled
+#define EDGETHICKNESS 24
+#define MAXSAMPLINGLENGTH 1920
+
 #define PLASMACONFIG "plasma-org.kde.plasma.desktop-appletsrc"
 #define DEFAULTWALLPAPER "wallpapers/Next/contents/images/1920x1080.png"
 
@@ -67,11 +90,22 @@ BackgroundCache::BackgroundCache(QObject *parent)
         m_pool = new ScreenPool(this);
     }
 
+    m_hintsCacheFile = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QLatin1Char('/') + HINTSCACHEFILE;
+
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(HINTSCACHESAVEINTERVAL);
+    connect(&m_saveTimer, &QTimer::timeout, this, &BackgroundCache::saveHintsCache);
+
+    loadHintsCache();
+
+    //! worker threads must be finished and the hints must be stored while the application still exists
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &BackgroundCache::onAboutToQuit);
+
     reload();
 }
 
 BackgroundCache::~BackgroundCache()
-{   
+{
     if (m_pool) {
         m_pool->deleteLater();
     }
@@ -79,11 +113,33 @@ BackgroundCache::~BackgroundCache()
 
 BackgroundCache *BackgroundCache::self()
 {
-    static BackgroundCache cache;
-    return &cache;
+    static QPointer<BackgroundCache> cache;
+
+    if (!cache) {
+        cache = new BackgroundCache(qApp);
+    }
+
+    return cache;
+}
+
+void BackgroundCache::onAboutToQuit()
+{
+    //! stale calculations are waited also
+    for (auto watcher : findChildren<QFutureWatcher<imageEntry> *>()) {
+        watcher->waitForFinished();
+    }
+
+    if (m_saveTimer.isActive()) {
+        saveHintsCache();
+    }
 }
 
 void BackgroundCache::settingsFileChanged(const QString &file) {
+    if (m_watchedBackgrounds.contains(file)) {
+        backgroundFileChanged(file);
+        return;
+    }
+
     if (!file.endsWith(PLASMACONFIG)) {
         return;
     }
@@ -181,6 +237,8 @@ void BackgroundCache::reload()
 
     m_initialized = true;
 
+    updateWatchedBackgrounds();
+
     for (const auto &activity : updates.keys()) {
         for (const auto &screen : updates[activity]) {
             emit backgroundChanged(activity, screen);
@@ -199,50 +257,142 @@ QString BackgroundCache::background(QString activity, QString screen) const
 
 bool BackgroundCache::busyFor(QString activity, QString screen, Plasma::Types::Location location)
 {
+    return hintsFor(activity, screen, location).busy;
+}
+
+float BackgroundCache::brightnessFor(QString activity, QString screen, Plasma::Types::Location location)
+{
+    return hintsFor(activity, screen, location).brightness;
+}
+
+//! Hints are never calculated in the calling thread. When they are not ready yet,
+//! the image calculations are scheduled and the previous hints for that activity,
+//! screen and edge are returned. hintsReady() is emitted when the new ones are available.
+imageHints BackgroundCache::hintsFor(QString activity, QString screen, Plasma::Types::Location location)
+{
+    imageHints hints;
     QString assignedBackground = background(activity, screen);
 
-    if (!assignedBackground.isEmpty()) {
-        return busyForFile(assignedBackground, location);
+    if (assignedBackground.isEmpty()) {
+        return hints;
     }
 
-    return false;
+    //! if it is a color
+    if (assignedBackground.startsWith("#")) {
+        hints.brightness = Latte::colorBrightness(QColor(assignedBackground));
+        hints.busy = false;
+        m_lastHints[activity][screen][location] = hints;
+        return hints;
+    }
+
+    if (m_hintsCache.contains(assignedBackground) && !m_validatedHints.contains(assignedBackground)) {
+        //! hints loaded from the disk cache are checked against the image file only once,
+        //! afterwards changes are tracked through the file watcher
+        qint64 lastModified; qint64 size;
+        fileStats(assignedBackground, lastModified, size);
+
+        const imageEntry &entry = m_hintsCache[assignedBackground];
+
+        if (entry.lastModified == lastModified && entry.size == size) {
+            m_validatedHints << assignedBackground;
+        } else {
+            //! the image file was changed in place
+            removeHints(assignedBackground);
+        }
+    }
+
+    if (m_hintsCache.contains(assignedBackground)) {
+        const imageEntry &entry = m_hintsCache[assignedBackground];
+
+        //! an image that could not be analyzed provides no hints for its edges
+        if (entry.edges.contains(location)) {
+            hints = entry.edges[location];
+        }
+
+        touchHints(assignedBackground);
+        m_lastHints[activity][screen][location] = hints;
+        return hints;
+    }
+
+    requestImageCalculations(assignedBackground, activity, screen, location);
+
+    if (m_lastHints.contains(activity) && m_lastHints[activity].contains(screen) && m_lastHints[activity][screen].contains(location)) {
+        return m_lastHints[activity][screen][location];
+    }
+
+    return hints;
 }
 
-float BackgroundCache::brightnessFor(QString activity, QString screen, Plasma::Types::Location location)
+void BackgroundCache::requestImageCalculations(QString imageFile, QString activity, QString screen, Plasma::Types::Location location)
 {
-    QString assignedBackground = background(activity, screen);
+    hintsRequest request;
+    request.activity = activity; request.screen = screen; request.location = location;
 
-    if (!assignedBackground.isEmpty()) {
-        return brightnessForFile(assignedBackground, location);
+    if (!m_pendingRequests[imageFile].contains(request)) {
+        m_pendingRequests[imageFile].append(request);
     }
 
-    return -1000;
+    //! the same image is decoded only once for all views and edges
+    if (m_pendingCalculations.contains(imageFile)) {
+        return;
+    }
+
+    startImageCalculations(imageFile);
 }
 
-float BackgroundCache::brightnessFromArea(QImage &image, int firstRow, int firstColumn, int endRow, int endColumn)
+void BackgroundCache::startImageCalculations(QString imageFile)
 {
-    float areaBrightness = -1000;
+    auto watcher = new QFutureWatcher<imageEntry>(this);
+    m_pendingCalculations[imageFile] = watcher;
 
-    if (image.format() != QImage::Format_Invalid) {
-        for (int row = firstRow; row < endRow; ++row) {
-            QRgb *line = (QRgb *)image.scanLine(row);
+    connect(watcher, &QFutureWatcher<imageEntry>::finished, this, [this, imageFile]() {
+        imageCalculationsFinished(imageFile);
+    });
 
-            for (int col = firstColumn; col < endColumn ; ++col) {
-                QRgb pixelData = line[col];
-                float pixelBrightness = Latte::colorBrightness(pixelData);
+    watcher->setFuture(QtConcurrent::run(&BackgroundCache::imageCalculations, imageFile));
+}
 
-                areaBrightness = (areaBrightness == -1000) ? pixelBrightness : (areaBrightness + pixelBrightness);
-            }
-        }
+void BackgroundCache::imageCalculationsFinished(QString imageFile)
+{
+    if (!m_pendingCalculations.contains(imageFile)) {
+        return;
+    }
+
+    QFutureWatcher<imageEntry> *watcher = m_pendingCalculations.take(imageFile);
+
+    m_hintsCache[imageFile] = watcher->result();
+    m_validatedHints << imageFile;
+    touchHints(imageFile);
+    watcher->deleteLater();
+
+    m_saveTimer.start();
+
+    const QList<hintsRequest> requests = m_pendingRequests.take(imageFile);
 
-        float areaSize = (endRow - firstRow) * (endColumn - firstColumn);
-        areaBrightness = areaBrightness / areaSize;
+    for (const auto &request : requests) {
+        emit hintsReady(request.activity, request.screen, request.location);
     }
+}
+
+float BackgroundCache::brightnessFromArea(const QImage &image, const QRect &area)
+{
+    if (image.isNull() || area.isEmpty()) {
+        return -1000;
+    }
+
+    quint64 areaSum{0};
 
-    return areaBrightness;
+    for (int row = area.top(); row <= area.bottom(); ++row) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(image.constScanLine(row));
+        areaSum += Latte::colorBrightnessSum(line + area.left(), area.width());
+    }
+
+    quint64 areaSize = (quint64)area.width() * area.height();
+
+    return (float)((double)areaSum / (areaSize * 1000));
 }
 
-bool BackgroundCache::areaIsBusy(float bright1, float bright2) const
+bool BackgroundCache::areaIsBusy(float bright1, float bright2)
 {
     bool bright1IsLight = bright1>=123;
     bool bright2IsLight = bright2>=123;
@@ -252,6 +402,69 @@ bool BackgroundCache::areaIsBusy(float bright1, float bright2) const
     return !inBounds || bright1IsLight != bright2IsLight;
 }
 
+//! Decodes only the edge band of the image that is needed for the calculations and
+//! at reduced resolution when the image is large. Image handlers that support clip rect
+//! and scaled size natively (e.g. jpeg) avoid decoding the entire image this way.
+QImage BackgroundCache::edgeBand(QString imageFile, const QSize &imageSize, Plasma::Types::Location location)
+{
+    QImageReader reader(imageFile);
+    QRect band = edgeBandRect(imageSize, location);
+
+    reader.setClipRect(band);
+    reader.setScaledSize(edgeBandScaledSize(imageSize, band, location));
+
+    QImage image = reader.read();
+
+    if (image.isNull()) {
+        return QImage();
+    }
+
+    return image.convertToFormat(QImage::Format_RGB32);
+}
+
+//! used when the image handler can not provide the image size before decoding
+QImage BackgroundCache::edgeBand(const QImage &image, Plasma::Types::Location location)
+{
+    QRect band = edgeBandRect(image.size(), location);
+    QSize scaledBand = edgeBandScaledSize(image.size(), band, location);
+
+    return image.copy(band).scaled(scaledBand, Qt::IgnoreAspectRatio, Qt::SmoothTransformation).convertToFormat(QImage::Format_RGB32);
+}
+
+QRect BackgroundCache::edgeBandRect(const QSize &imageSize, Plasma::Types::Location location)
+{
+    //! 24px. should be enough because the views are always snapped to edges
+    int thickness = (location == Plasma::Types::LeftEdge || location == Plasma::Types::RightEdge) ?
+                qMin(EDGETHICKNESS, imageSize.width()) : qMin(EDGETHICKNESS, imageSize.height());
+
+    switch (location) {
+    case Plasma::Types::TopEdge:
+        return QRect(0, 0, imageSize.width(), thickness);
+    case Plasma::Types::LeftEdge:
+        return QRect(0, 0, thickness, imageSize.height());
+    case Plasma::Types::RightEdge:
+        return QRect(imageSize.width() - thickness, 0, thickness, imageSize.height());
+    case Plasma::Types::BottomEdge:
+    default:
+        return QRect(0, imageSize.height() - thickness, imageSize.width(), thickness);
+    }
+}
+
+QSize BackgroundCache::edgeBandScaledSize(const QSize &imageSize, const QRect &band, Plasma::Types::Location location)
+{
+    bool vertical = (location == Plasma::Types::LeftEdge || location == Plasma::Types::RightEdge) ? true : false;
+    int imageLength = !vertical ? imageSize.width() : imageSize.height();
+
+    if (imageLength <= MAXSAMPLINGLENGTH) {
+        return band.size();
+    }
+
+    //! preserve the image aspect ratio, brightness of the band is not affected by the downscaling
+    float factor = (float)MAXSAMPLINGLENGTH / imageLength;
+
+    return QSize(qMax(1, qRound(band.width() * factor)), qMax(1, qRound(band.height() * factor)));
+}
+
 //! In order to calculate the brightness and busy hints for specific image
 //! the code is doing the following. It is not needed to calculate these values
 //! for the entire image that would also be cpu costly. The function takes
@@ -261,176 +474,283 @@ bool BackgroundCache::areaIsBusy(float bright1, float bright2) const
 //! area brightness. In order to indicate if this area is busy or not we
 //! compare the minimum and the maximum values of brightness from these
 //! tiles. If the difference it too big then the area is busy
-void BackgroundCache::updateImageCalculations(QString imageFile, Plasma::Types::Location location)
+imageHints BackgroundCache::edgeHints(const QImage &band, Plasma::Types::Location location)
 {
-    if (m_hintsCache.size() > MAXHASHSIZE) {
-        cleanupHashes();
+    float maxBrightness{0};
+    float minBrightness{255};
+
+    bool vertical = (location == Plasma::Types::LeftEdge || location == Plasma::Types::RightEdge) ? true : false;
+    int bandLength = !vertical ? band.width() : band.height();
+    int tiles{qMin(10,bandLength)};
+
+    QList<float> subBrightness;
+
+    qDebug() << "Hints for Background image | Edge: " << location << ", Sampled band size: " << band.width() << "x" << band.height() << ", Tiles: " << tiles;
+
+    for (int i=0; i<tiles; ++i) {
+        int firstPixel = (i * bandLength) / tiles;
+        int endPixel = ((i+1) * bandLength) / tiles;
+
+        QRect tile = !vertical ? QRect(firstPixel, 0, endPixel - firstPixel, band.height()) :
+                                 QRect(0, firstPixel, band.width(), endPixel - firstPixel);
+
+        float tempBrightness = brightnessFromArea(band, tile);
+        qDebug() << " Tile considering << " << tile << ", brightness: " << tempBrightness;
+
+        subBrightness.append(tempBrightness);
+
+        if (tempBrightness > maxBrightness) {
+            maxBrightness = tempBrightness;
+        }
+        if (tempBrightness < minBrightness) {
+            minBrightness = tempBrightness;
+        }
     }
 
-    //! if it is a local image
-    QImage image(imageFile);
+    //! compute total brightness for this area
+    float subBrightnessSum = 0;
 
-    if (image.format() != QImage::Format_Invalid) {
-        float brightness{-1000};
-        float maxBrightness{0};
-        float minBrightness{255};
+    for (int i=0; i<subBrightness.count(); ++i) {
+        subBrightnessSum = subBrightnessSum + subBrightness[i];
+    }
 
-        bool vertical = (location == Plasma::Types::LeftEdge || location == Plasma::Types::RightEdge) ? true : false;
-        int imageLength = !vertical ? image.width() : image.height();
-        int tiles{qMin(10,imageLength)};
+    imageHints hints;
+    hints.brightness = subBrightness.count() > 0 ? subBrightnessSum / subBrightness.count() : -1000;
+    hints.busy = areaIsBusy(minBrightness, maxBrightness);
 
-        //! 24px. should be enough because the views are always snapped to edges
-        int tileThickness = !vertical ? qMin(24,image.height()) : qMin(24,image.width());
-        int tileLength = imageLength / tiles ;
+    qDebug() << "Hints for Background image | Brightness: " << hints.brightness << ", Busy: " << hints.busy << ", minBright:" << minBrightness << ", maxBright:" << maxBrightness;
 
-        int tileWidth = !vertical ? tileLength : tileThickness;
-        int tileHeight = !vertical ? tileThickness : tileLength;
+    return hints;
+}
 
-        float factor = ((float)100/tiles)/100;
+//! runs in a worker thread, it must not access any BackgroundCache members
+imageEntry BackgroundCache::imageCalculations(QString imageFile)
+{
+    imageEntry entry;
+    fileStats(imageFile, entry.lastModified, entry.size);
 
-        QList<float> subBrightness;
+    QElapsedTimer timer;
+    timer.start();
 
-        qDebug() << "------------   -- Image Calculations --  --------------" ;
-        qDebug() << "Hints for Background image | " << imageFile;
-        qDebug() << "Hints for Background image | Edge: " << location << ", Image size: " << image.width() << "x" << image.height() << ", Tiles: " << tiles << ", subsize: " << tileWidth << "x" << tileHeight;
+    QImage image;
+    QSize imageSize = QImageReader(imageFile).size();
 
-        //! Iterating algorigthm
-        int firstRow = 0; int firstColumn = 0; int endRow = 0; int endColumn = 0;
+    if (!imageSize.isValid()) {
+        //! the image handler can not provide the size before decoding so the image is decoded only once
+        image = QImage(imageFile);
 
-        //! horizontal tiles calculations
-        if (location == Plasma::Types::TopEdge) {
-            firstRow = 0; endRow = tileThickness;
-        } else if (location == Plasma::Types::BottomEdge) {
-            firstRow = image.height() - tileThickness - 1; endRow = image.height() - 1;
+        if (image.isNull()) {
+            return entry;
         }
 
-        if (!vertical) {
-            for (int i=1; i<=tiles; ++i) {
-                float subFactor = ((float)i) * factor;
-                firstColumn = endColumn+1; endColumn = (subFactor*imageLength) - 1;
-                endColumn = qMin(endColumn, imageLength-1);
+        imageSize = image.size();
+    }
 
-                int tempBrightness = brightnessFromArea(image, firstRow, firstColumn, endRow, endColumn);
-                qDebug() << " Tile considering horizontal << (" << firstColumn << "," << firstRow << ") - (" << endColumn << "," << endRow << "), subfactor: " << subFactor
-                         << ", brightness: " << tempBrightness;
+    qDebug() << "------------   -- Image Calculations --  --------------" ;
+    qDebug() << "Hints for Background image | " << imageFile << ", Image size: " << imageSize.width() << "x" << imageSize.height();
 
-                subBrightness.append(tempBrightness);
+    const QList<Plasma::Types::Location> edges{Plasma::Types::TopEdge, Plasma::Types::BottomEdge,
+                Plasma::Types::LeftEdge, Plasma::Types::RightEdge};
 
-                if (tempBrightness > maxBrightness) {
-                    maxBrightness = tempBrightness;
-                }
-                if (tempBrightness < minBrightness) {
-                    minBrightness = tempBrightness;
-                }
-            }
-        }
+    for (const auto edge : edges) {
+        QImage band = image.isNull() ? edgeBand(imageFile, imageSize, edge) : edgeBand(image, edge);
 
-        //! vertical tiles calculations
-        if (location == Plasma::Types::LeftEdge) {
-            firstColumn = 0; endColumn = tileThickness;
-        } else if (location == Plasma::Types::RightEdge) {
-            firstColumn = image.width() - 1 - tileThickness; endColumn = image.width() - 1;
+        if (!band.isNull()) {
+            entry.edges[edge] = edgeHints(band, edge);
         }
+    }
 
-        if (vertical) {
-            for (int i=1; i<=tiles; ++i) {
-                float subFactor = ((float)i) * factor;
-                firstRow = endRow+1; endRow = (subFactor*imageLength) - 1;
-                endRow = qMin(endRow, imageLength-1);
+    qDebug() << "Hints for Background image | decoding and sampling time: " << timer.nsecsElapsed() / 1000 << "us";
 
-                int tempBrightness = brightnessFromArea(image, firstRow, firstColumn, endRow, endColumn);
-                qDebug() << " Tile considering vertical << (" << firstColumn << "," << firstRow << ") - (" << endColumn << "," << endRow << "), subfactor: " << subFactor
-                         << ", brightness: " << tempBrightness;
+    return entry;
+}
 
-                subBrightness.append(tempBrightness);
+void BackgroundCache::fileStats(QString file, qint64 &lastModified, qint64 &size)
+{
+    QFileInfo info(file);
 
-                if (tempBrightness > maxBrightness) {
-                    maxBrightness = tempBrightness;
-                }
-                if (tempBrightness < minBrightness) {
-                    minBrightness = tempBrightness;
-                }
-            }
-        }
-        //! compute total brightness for this area
-        float subBrightnessSum = 0;
+    if (!info.exists()) {
+        lastModified = -1;
+        size = -1;
+        return;
+    }
 
-        for (int i=0; i<subBrightness.count(); ++i) {
-            subBrightnessSum = subBrightnessSum + subBrightness[i];
-        }
+    lastModified = info.lastModified().toMSecsSinceEpoch();
+    size = info.size();
+}
+
+//! least recently used images are evicted first
+void BackgroundCache::touchHints(QString imageFile)
+{
+    if (!m_hintsUsage.isEmpty() && m_hintsUsage.last() == imageFile) {
+        return;
+    }
+
+    m_hintsUsage.removeOne(imageFile);
+    m_hintsUsage.append(imageFile);
+
+    while (m_hintsUsage.count() > MAXHASHSIZE) {
+        QString evicted = m_hintsUsage.takeFirst();
+        m_hintsCache.remove(evicted);
+        m_validatedHints.remove(evicted);
+    }
+}
+
+void BackgroundCache::removeHints(QString imageFile)
+{
+    m_hintsCache.remove(imageFile);
+    m_validatedHints.remove(imageFile);
+    m_hintsUsage.removeOne(imageFile);
+    m_saveTimer.start();
+}
+
+//! Binary format: magic, version, entries count and for each entry, from the least
+//! to the most recently used: path, last modified msecs, file size, edges count and
+//! for each edge: location, brightness, busy
+void BackgroundCache::loadHintsCache()
+{
+    QFile file(m_hintsCacheFile);
 
-        brightness = subBrightnessSum / subBrightness.count();
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_9);
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
 
-        bool areaBusy = areaIsBusy(minBrightness, maxBrightness);
+    quint32 magic; quint32 version; quint32 count;
+    in >> magic >> version >> count;
+
+    if (in.status() != QDataStream::Ok || magic != HINTSCACHEMAGIC || version != HINTSCACHEVERSION) {
+        return;
+    }
 
-        qDebug() << "Hints for Background image | Brightness: " << brightness << ", Busy: " << areaBusy << ", minBright:" << minBrightness << ", maxBright:" << maxBrightness;
+    for (quint32 i=0; i<count; ++i) {
+        QString imageFile;
+        imageEntry entry;
+        quint8 edgesCount;
 
-        if (!m_hintsCache.keys().contains(imageFile)) {
-            m_hintsCache[imageFile] = EdgesHash();
+        in >> imageFile >> entry.lastModified >> entry.size >> edgesCount;
+
+        for (quint8 j=0; j<edgesCount; ++j) {
+            qint32 location;
+            imageHints hints;
+
+            in >> location >> hints.brightness >> hints.busy;
+            entry.edges[static_cast<Plasma::Types::Location>(location)] = hints;
         }
 
-        if (!m_hintsCache[imageFile].contains(location)) {
-            imageHints iHints;
-            iHints.brightness = brightness; iHints.busy = areaBusy;
-            m_hintsCache[imageFile].insert(location, iHints);
-        } else {
-            m_hintsCache[imageFile][location].brightness = brightness;
-            m_hintsCache[imageFile][location].busy = areaBusy;
+        if (in.status() != QDataStream::Ok) {
+            qDebug() << "Background hints cache is corrupted and it is ignored :: " << m_hintsCacheFile;
+            m_hintsCache.clear();
+            m_hintsUsage.clear();
+            return;
         }
+
+        m_hintsCache[imageFile] = entry;
+        touchHints(imageFile);
     }
 }
 
-float BackgroundCache::brightnessForFile(QString imageFile, Plasma::Types::Location location)
+void BackgroundCache::saveHintsCache()
 {
-    if (m_hintsCache.keys().contains(imageFile)) {
-        if (m_hintsCache[imageFile].keys().contains(location)) {
-            return m_hintsCache[imageFile][location].brightness;
-        }
+    m_saveTimer.stop();
+
+    QDir().mkpath(QFileInfo(m_hintsCacheFile).absolutePath());
+
+    QSaveFile file(m_hintsCacheFile);
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
     }
 
-    //! if it is a color
-    if (imageFile.startsWith("#")) {
-        return Latte::colorBrightness(QColor(imageFile));
+    //! images that could not be analyzed are not stored
+    QStringList imageFiles;
+
+    for (const auto &imageFile : m_hintsUsage) {
+        if (!m_hintsCache[imageFile].edges.isEmpty()) {
+            imageFiles << imageFile;
+        }
     }
 
-    updateImageCalculations(imageFile, location);
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_9);
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    out << (quint32)HINTSCACHEMAGIC << (quint32)HINTSCACHEVERSION << (quint32)imageFiles.count();
+
+    for (const auto &imageFile : imageFiles) {
+        const imageEntry &entry = m_hintsCache[imageFile];
 
-    if (m_hintsCache.keys().contains(imageFile)) {
-        return m_hintsCache[imageFile][location].brightness;
+        out << imageFile << entry.lastModified << entry.size << (quint8)entry.edges.count();
+
+        for (auto edge = entry.edges.constBegin(); edge != entry.edges.constEnd(); ++edge) {
+            out << (qint32)edge.key() << edge.value().brightness << edge.value().busy;
+        }
     }
 
-    return -1000;
+    file.commit();
 }
 
-bool BackgroundCache::busyForFile(QString imageFile, Plasma::Types::Location location)
+void BackgroundCache::backgroundFileChanged(const QString &file)
 {
-    if (m_hintsCache.keys().contains(imageFile)) {
-        if (m_hintsCache[imageFile].keys().contains(location)) {
-            return m_hintsCache[imageFile][location].busy;
-        }
+    if (!m_hintsCache.contains(file) && !m_pendingCalculations.contains(file)) {
+        return;
     }
 
-    //! if it is a color
-    if (imageFile.startsWith("#")) {
-        return false;
-    }
+    qDebug() << "Background image file changed :: " << file;
+
+    removeHints(file);
 
-    updateImageCalculations(imageFile, location);
+    if (m_pendingCalculations.contains(file)) {
+        //! the running calculation decodes the previous image, so its result is discarded
+        //! and the calculation starts again for the current one
+        QFutureWatcher<imageEntry> *staleWatcher = m_pendingCalculations.take(file);
+        disconnect(staleWatcher, nullptr, this, nullptr);
+        connect(staleWatcher, &QFutureWatcher<imageEntry>::finished, staleWatcher, &QObject::deleteLater);
 
-    if (m_hintsCache.keys().contains(imageFile)) {
-        return m_hintsCache[imageFile][location].busy;
+        if (staleWatcher->isFinished()) {
+            staleWatcher->deleteLater();
+        }
+
+        startImageCalculations(file);
     }
 
-    return false;
+    for (const auto &activity : m_backgrounds.keys()) {
+        for (const auto &screen : m_backgrounds[activity].keys()) {
+            if (m_backgrounds[activity][screen] == file) {
+                emit backgroundChanged(activity, screen);
+            }
+        }
+    }
 }
 
-void BackgroundCache::cleanupHashes()
+void BackgroundCache::updateWatchedBackgrounds()
 {
-    if (m_hintsCache.count() <= MAXHASHSIZE) {
-        return;
+    QSet<QString> backgrounds;
+
+    for (const auto &screens : m_backgrounds) {
+        for (const auto &background : screens) {
+            if (!background.startsWith("#")) {
+                backgrounds << background;
+            }
+        }
+    }
+
+    for (const auto &file : m_watchedBackgrounds) {
+        if (!backgrounds.contains(file)) {
+            KDirWatch::self()->removeFile(file);
+        }
+    }
+
+    for (const auto &file : backgrounds) {
+        if (!m_watchedBackgrounds.contains(file)) {
+            KDirWatch::self()->addFile(file);
+        }
     }
 
-    m_hintsCache.clear();
+    m_watchedBackgrounds = backgrounds;
 }
 
 void BackgroundCache::setBackgroundFromBroadcast(QString activity, QString screen, QString filename)
@@ -438,6 +758,7 @@ void BackgroundCache::setBackgroundFromBroadcast(QString activity, QString scree
     if (QFileInfo(filename).exists()) {
         setBroadcastedBackgroundsEnabled(activity, screen, true);
         m_backgrounds[activity][screen] = filename;
+        updateWatchedBackgrounds();
         emit backgroundChanged(activity, screen);
     }
 }
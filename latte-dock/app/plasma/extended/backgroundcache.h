@@ -24,8 +24,14 @@
 #include "screenpool.h"
 
 // Qt
+#include <QFutureWatcher>
 #include <QHash>
+#include <QImage>
+#include <QList>
 #include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
 
 // Plasma
 #include <Plasma>
@@ -41,6 +47,24 @@ struct imageHints {
 
 typedef QHash<Plasma::Types::Location, imageHints> EdgesHash;
 
+//! hints for all edges of an image file, they are valid only for the
+//! file modification time and size they were calculated for
+struct imageEntry {
+    qint64 lastModified{-1};
+    qint64 size{-1};
+    EdgesHash edges;
+};
+
+struct hintsRequest {
+    QString activity;
+    QString screen;
+    Plasma::Types::Location location{Plasma::Types::Floating};
+
+    bool operator==(const hintsRequest &other) const {
+        return activity == other.activity && screen == other.screen && location == other.location;
+    }
+};
+
 namespace Latte {
 namespace PlasmaExtended {
 
@@ -62,8 +86,10 @@ public:
 
 signals:
     void backgroundChanged(const QString &activity, const QString &screenName);
+    void hintsReady(const QString &activity, const QString &screenName, Plasma::Types::Location location);
 
 private slots:
+    void onAboutToQuit();
     void reload();
     void settingsFileChanged(const QString &file);
 
@@ -72,16 +98,35 @@ private:
 
     bool backgroundIsBroadcasted(QString activity, QString screenName) const;
     bool pluginExistsFor(QString activity, QString screenName) const;
-    bool areaIsBusy(float bright1, float bright2) const;
-    bool busyForFile(QString imageFile, Plasma::Types::Location location);
     bool isDesktopContainment(const KConfigGroup &containment) const;
 
-    float brightnessForFile(QString imageFile, Plasma::Types::Location location);
-    float brightnessFromArea(QImage &image, int firstRow, int firstColumn, int endRow, int endColumn);
     QString backgroundFromConfig(const KConfigGroup &config, QString wallpaperPlugin) const;
 
-    void cleanupHashes();
-    void updateImageCalculations(QString imageFile, Plasma::Types::Location location);
+    imageHints hintsFor(QString activity, QString screen, Plasma::Types::Location location);
+
+    void imageCalculationsFinished(QString imageFile);
+    void requestImageCalculations(QString imageFile, QString activity, QString screen, Plasma::Types::Location location);
+    void startImageCalculations(QString imageFile);
+
+    void loadHintsCache();
+    void saveHintsCache();
+    void removeHints(QString imageFile);
+    void touchHints(QString imageFile);
+
+    void backgroundFileChanged(const QString &file);
+    void updateWatchedBackgrounds();
+
+    //! image calculations, they run in worker threads
+    static bool areaIsBusy(float bright1, float bright2);
+    static float brightnessFromArea(const QImage &image, const QRect &area);
+
+    static imageEntry imageCalculations(QString imageFile);
+    static imageHints edgeHints(const QImage &band, Plasma::Types::Location location);
+    static QImage edgeBand(QString imageFile, const QSize &imageSize, Plasma::Types::Location location);
+    static QImage edgeBand(const QImage &image, Plasma::Types::Location location);
+    static QRect edgeBandRect(const QSize &imageSize, Plasma::Types::Location location);
+    static QSize edgeBandScaledSize(const QSize &imageSize, const QRect &band, Plasma::Types::Location location);
+    static void fileStats(QString file, qint64 &lastModified, qint64 &size);
 
 private:
     bool m_initialized{false};
@@ -100,8 +145,25 @@ private:
     //! and have higher priority: activity id, screen names
     QHash<QString, QList<QString>> m_broadcasted;
 
-    //! image file and brightness per edge
-    QHash<QString, EdgesHash> m_hintsCache;
+    QString m_hintsCacheFile;
+
+    //! image file and brightness per edge, it is persisted in m_hintsCacheFile
+    QHash<QString, imageEntry> m_hintsCache;
+    //! image files from the least to the most recently used
+    QStringList m_hintsUsage;
+    //! image files whose cached hints were checked against their modification time and size
+    QSet<QString> m_validatedHints;
+    //! background image files that are tracked for changes
+    QSet<QString> m_watchedBackgrounds;
+
+    QTimer m_saveTimer;
+
+    //! last provided hints: activity id, screen name, edge
+    QHash<QString, QHash<QString, EdgesHash>> m_lastHints;
+
+    //! image files that are currently analyzed and the requests waiting for them
+    QHash<QString, QFutureWatcher<imageEntry> *> m_pendingCalculations;
+    QHash<QString, QList<hintsRequest>> m_pendingRequests;
 
     KSharedConfig::Ptr m_plasmaConfig;
 };
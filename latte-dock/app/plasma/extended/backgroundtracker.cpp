@@ -33,6 +33,7 @@ BackgroundTracker::BackgroundTracker(QObject *parent)
     connect(this, &BackgroundTracker::screenNameChanged, this, &BackgroundTracker::update);
 
     connect(PlasmaExtended::BackgroundCache::self(), &PlasmaExtended::BackgroundCache::backgroundChanged, this, &BackgroundTracker::backgroundChanged);
+    connect(PlasmaExtended::BackgroundCache::self(), &PlasmaExtended::BackgroundCache::hintsReady, this, &BackgroundTracker::hintsReady);
 }
 
 BackgroundTracker::~BackgroundTracker()
@@ -106,17 +107,31 @@ void BackgroundTracker::backgroundChanged(const QString &activity, const QString
     }
 }
 
+void BackgroundTracker::hintsReady(const QString &activity, const QString &screenName, Plasma::Types::Location location)
+{
+    if (m_activity==activity && m_screenName==screenName && m_location==location) {
+        update();
+    }
+}
+
 void BackgroundTracker::update()
 {
     if (m_activity.isEmpty() || m_screenName.isEmpty()) {
         return;
     }
 
-    m_brightness = PlasmaExtended::BackgroundCache::self()->brightnessFor(m_activity, m_screenName, m_location);
-    m_busy = PlasmaExtended::BackgroundCache::self()->busyFor(m_activity, m_screenName, m_location);
+    float brightness = PlasmaExtended::BackgroundCache::self()->brightnessFor(m_activity, m_screenName, m_location);
+    bool busy = PlasmaExtended::BackgroundCache::self()->busyFor(m_activity, m_screenName, m_location);
+
+    if (m_brightness != brightness) {
+        m_brightness = brightness;
+        emit currentBrightnessChanged();
+    }
 
-    emit currentBrightnessChanged();
-    emit isBusyChanged();
+    if (m_busy != busy) {
+        m_busy = busy;
+        emit isBusyChanged();
+    }
 }
 
 }
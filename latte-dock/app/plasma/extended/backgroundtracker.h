@@ -68,6 +68,7 @@ signals:
 
 private slots:
     void backgroundChanged(const QString &activity, const QString &screenName);
+    void hintsReady(const QString &activity, const QString &screenName, Plasma::Types::Location location);
     void update();
 
 private:
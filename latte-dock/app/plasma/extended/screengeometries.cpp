@@ -65,9 +65,10 @@ ScreenGeometries::~ScreenGeometries()
 
 void ScreenGeometries::init()
 {
-    QDBusInterface plasmaStrutsIface(PLASMASERVICE, "/StrutManager", PLASMASTRUTNAMESPACE, QDBusConnection::sessionBus());
+    //! the interface is created only once because its creation blocks until plasmashell is introspected
+    m_plasmaStrutsIface = new QDBusInterface(PLASMASERVICE, "/StrutManager", PLASMASTRUTNAMESPACE, QDBusConnection::sessionBus(), this);
 
-    if (plasmaStrutsIface.isValid()) {
+    if (m_plasmaStrutsIface->isValid()) {
         m_plasmaInterfaceAvailable = true;
 
         qDebug() << " PLASMA STRUTS MANAGER :: is available...";
@@ -99,18 +100,45 @@ bool ScreenGeometries::screenIsActive(const QString &screenName) const
     return false;
 }
 
+void ScreenGeometries::publish(const QString &method, const QString &screenName, const QVariant &geometry)
+{
+    QDBusPendingCall call = m_plasmaStrutsIface->asyncCall(method, LATTESERVICE, screenName, geometry);
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, this);
+
+    m_pendingCalls++;
+
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, &ScreenGeometries::publishFinished);
+}
+
+void ScreenGeometries::publishFinished(QDBusPendingCallWatcher *watcher)
+{
+    if (watcher->isError()) {
+        qDebug() << " PLASMA SCREEN GEOMETRIES, publish failed :: " << watcher->error().message();
+    }
+
+    watcher->deleteLater();
+    m_pendingCalls--;
+
+    //! send only the latest geometries, intermediate updates were superseded
+    if (m_pendingCalls == 0 && m_publishPending) {
+        updateGeometries();
+    }
+}
+
 void ScreenGeometries::updateGeometries()
 {
-    if (!m_plasmaInterfaceAvailable) {
+    if (!m_plasmaInterfaceAvailable || !m_plasmaStrutsIface) {
         return;
     }
 
-    QDBusInterface plasmaStrutsIface(PLASMASERVICE, "/StrutManager", PLASMASTRUTNAMESPACE, QDBusConnection::sessionBus());
-
-    if (!plasmaStrutsIface.isValid()) {
+    //! plasmashell has not processed the previous batch yet
+    if (m_pendingCalls > 0) {
+        m_publishPending = true;
         return;
     }
 
+    m_publishPending = false;
+
     QStringList availableScreenNames;
 
     qDebug() << " PLASMA SCREEN GEOMETRIES, LAST AVAILABLE SCREEN RECTS :: " << m_lastAvailableRect;
@@ -142,20 +170,16 @@ void ScreenGeometries::updateGeometries()
             //! is using a different layout. When the user from Unity is switching to
             //! Music and afterwards to Canvas the desktop elements are not positioned properly
             if (m_forceGeometryBroadcast) {
-                plasmaStrutsIface.call("setAvailableScreenRect", LATTESERVICE, scrName, QRect());
+                publish("setAvailableScreenRect", scrName, QRect());
             }
 
             //! Disable checks because of the workaround concerning plasma desktop behavior
             if (m_forceGeometryBroadcast || (!m_lastAvailableRect.contains(scrName) || m_lastAvailableRect[scrName] != availableRect)) {
                 m_lastAvailableRect[scrName] = availableRect;
-                plasmaStrutsIface.call("setAvailableScreenRect", LATTESERVICE, scrName, availableRect);
+                publish("setAvailableScreenRect", scrName, availableRect);
                 qDebug() << " PLASMA SCREEN GEOMETRIES, AVAILABLE RECT :: " << screen->name() << " : " << availableRect;
             }
 
-            if (m_forceGeometryBroadcast) {
-                m_forceGeometryBroadcast = false;
-            }
-
             if (!m_lastAvailableRegion.contains(scrName) || m_lastAvailableRegion[scrName] != availableRegion) {
                 m_lastAvailableRegion[scrName] = availableRegion;
 
@@ -165,7 +189,7 @@ void ScreenGeometries::updateGeometries()
                     rects << rect;
                 }
 
-                plasmaStrutsIface.call("setAvailableScreenRegion", LATTESERVICE, scrName, QVariant::fromValue(rects));
+                publish("setAvailableScreenRegion", scrName, QVariant::fromValue(rects));
                 qDebug() << " PLASMA SCREEN GEOMETRIES, AVAILABLE REGION :: " << screen->name() << " : " << availableRegion;
             }
         }
@@ -173,12 +197,14 @@ void ScreenGeometries::updateGeometries()
         availableScreenNames << scrName;
     }
 
+    m_forceGeometryBroadcast = false;
+
     //! check for inactive screens that were published previously
     for (QString &lastScrName : m_lastScreenNames) {
         if (!screenIsActive(lastScrName)) {
             //! screen became inactive and its geometries could be unpublished
-            plasmaStrutsIface.call("setAvailableScreenRect", LATTESERVICE, lastScrName, QRect());
-            plasmaStrutsIface.call("setAvailableScreenRegion", LATTESERVICE, lastScrName, QVariant::fromValue(QList<QRect>()));
+            publish("setAvailableScreenRect", lastScrName, QRect());
+            publish("setAvailableScreenRegion", lastScrName, QVariant::fromValue(QList<QRect>()));
 
             m_lastAvailableRect.remove(lastScrName);
             m_lastAvailableRegion.remove(lastScrName);
@@ -29,6 +29,8 @@
 #include <QObject>
 #include <QTimer>
 
+class QDBusInterface;
+class QDBusPendingCallWatcher;
 
 namespace Latte {
 class Corona;
@@ -51,13 +53,21 @@ private slots:
 
     void init();
     void updateGeometries();
+    void publishFinished(QDBusPendingCallWatcher *watcher);
 
 private slots:
     bool screenIsActive(const QString &screenName) const;
 
+private:
+    //! geometries are sent asynchronously, all screens of an update are sent as one batch
+    void publish(const QString &method, const QString &screenName, const QVariant &geometry);
+
 private:
     bool m_plasmaInterfaceAvailable{false};
     bool m_forceGeometryBroadcast{false};
+    bool m_publishPending{false};
+
+    int m_pendingCalls{0};
 
     //! this is needed in order to avoid too many costly calculations for available screen geometries
     QTimer m_publishTimer;
@@ -67,6 +77,8 @@ private:
 
     Latte::Corona *m_corona{nullptr};
 
+    QDBusInterface *m_plasmaStrutsIface{nullptr};
+
     QList<Latte::Types::Visibility> m_ignoreModes{
         Latte::Types::AutoHide,
         Latte::Types::SideBar
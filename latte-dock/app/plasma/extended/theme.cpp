@@ -25,9 +25,11 @@
 #include "../../layouts/importer.h"
 #include "../../view/panelshadows_p.h"
 #include "../../wm/schemecolors.h"
+#include "../../wm/schemesregistry.h"
 #include "../../tools/commontools.h"
 
 // Qt
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QDir>
 #include <QProcess>
@@ -43,6 +45,11 @@
 #define DEFAULTCOLORSCHEME "default.colors"
 #define REVERSEDCOLORSCHEME "reversed.colors"
 
+//! increase when the roundness analysis changes in order to invalidate cached results
+#define ROUNDNESSCACHEVERSION 1
+//! how many theme signatures keep their roundness results
+#define ROUNDNESSCACHESIZE 5
+
 namespace Latte {
 namespace PlasmaExtended {
 
@@ -90,8 +97,8 @@ Theme::~Theme()
 {
     saveConfig();
 
-    m_defaultScheme->deleteLater();
-    m_reversedScheme->deleteLater();
+    WindowSystem::SchemesRegistry::self()->release(m_defaultScheme);
+    WindowSystem::SchemesRegistry::self()->release(m_reversedScheme);
 }
 
 bool Theme::hasShadow() const
@@ -216,10 +223,10 @@ void Theme::updateDefaultScheme()
 
     if (m_defaultScheme) {
         disconnect(m_defaultScheme, &WindowSystem::SchemeColors::colorsChanged, this, &Theme::loadThemeLightness);
-        m_defaultScheme->deleteLater();
+        WindowSystem::SchemesRegistry::self()->release(m_defaultScheme);
     }
 
-    m_defaultScheme = new WindowSystem::SchemeColors(this, m_defaultSchemePath, true);
+    m_defaultScheme = WindowSystem::SchemesRegistry::self()->acquire(m_defaultSchemePath, true);
     connect(m_defaultScheme, &WindowSystem::SchemeColors::colorsChanged, this, &Theme::loadThemeLightness);
 
     qDebug() << "plasma theme default colors ::: " << m_defaultSchemePath;
@@ -256,10 +263,10 @@ void Theme::updateReversedScheme()
     updateReversedSchemeValues();
 
     if (m_reversedScheme) {
-        m_reversedScheme->deleteLater();
+        WindowSystem::SchemesRegistry::self()->release(m_reversedScheme);
     }
 
-    m_reversedScheme = new WindowSystem::SchemeColors(this, m_reversedSchemePath, true);
+    m_reversedScheme = WindowSystem::SchemesRegistry::self()->acquire(m_reversedSchemePath, true);
 
     qDebug() << "plasma theme reversed colors ::: " << m_reversedSchemePath;
 }
@@ -433,9 +440,101 @@ void Theme::loadCompositingRoundness()
     svg->deleteLater();
 }
 
+QByteArray Theme::panelBackgroundSignature() const
+{
+    QString backgroundFile = m_theme.imagePath(QStringLiteral("widgets/panel-background"));
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(ROUNDNESSCACHEVERSION));
+    hash.addData(m_theme.themeName().toUtf8());
+    hash.addData(backgroundFile.toUtf8());
+
+    QFile file(backgroundFile);
+
+    if (file.open(QIODevice::ReadOnly)) {
+        hash.addData(&file);
+    }
+
+    return hash.result().toHex();
+}
+
+bool Theme::loadCachedRoundness(const QByteArray &signature)
+{
+    KConfigGroup cacheGroup(&m_themeGroup, "RoundnessCache");
+    QStringList signatures = cacheGroup.readEntry("signatures", QStringList());
+
+    if (!signatures.contains(QString(signature))) {
+        return false;
+    }
+
+    KConfigGroup themeGroup(&cacheGroup, QString(signature));
+
+    m_bottomEdgeRoundness = themeGroup.readEntry("bottomEdgeRoundness", 0);
+    m_leftEdgeRoundness = themeGroup.readEntry("leftEdgeRoundness", 0);
+    m_topEdgeRoundness = themeGroup.readEntry("topEdgeRoundness", 0);
+    m_rightEdgeRoundness = themeGroup.readEntry("rightEdgeRoundness", 0);
+
+    m_bottomEdgeMaxOpacity = themeGroup.readEntry("bottomEdgeMaxOpacity", 1.0);
+    m_leftEdgeMaxOpacity = themeGroup.readEntry("leftEdgeMaxOpacity", 1.0);
+    m_topEdgeMaxOpacity = themeGroup.readEntry("topEdgeMaxOpacity", 1.0);
+    m_rightEdgeMaxOpacity = themeGroup.readEntry("rightEdgeMaxOpacity", 1.0);
+
+    //! most recently used themes are kept first
+    if (signatures.first() != QString(signature)) {
+        signatures.removeAll(QString(signature));
+        signatures.prepend(QString(signature));
+        cacheGroup.writeEntry("signatures", signatures);
+    }
+
+    qDebug() << " COMPOSITING ROUNDNESS (cached) ::: " << m_bottomEdgeRoundness << " _ " << m_leftEdgeRoundness << " _ " << m_topEdgeRoundness << " _ " << m_rightEdgeRoundness;
+
+    return true;
+}
+
+void Theme::saveCachedRoundness(const QByteArray &signature)
+{
+    KConfigGroup cacheGroup(&m_themeGroup, "RoundnessCache");
+    QStringList signatures = cacheGroup.readEntry("signatures", QStringList());
+
+    //! entries of the single group cache that was used previously
+    for (const auto &key : cacheGroup.keyList()) {
+        if (key != QLatin1String("signatures")) {
+            cacheGroup.deleteEntry(key);
+        }
+    }
+
+    signatures.removeAll(QString(signature));
+    signatures.prepend(QString(signature));
+
+    while (signatures.count() > ROUNDNESSCACHESIZE) {
+        cacheGroup.deleteGroup(signatures.takeLast());
+    }
+
+    cacheGroup.writeEntry("signatures", signatures);
+
+    KConfigGroup themeGroup(&cacheGroup, QString(signature));
+
+    themeGroup.writeEntry("bottomEdgeRoundness", m_bottomEdgeRoundness);
+    themeGroup.writeEntry("leftEdgeRoundness", m_leftEdgeRoundness);
+    themeGroup.writeEntry("topEdgeRoundness", m_topEdgeRoundness);
+    themeGroup.writeEntry("rightEdgeRoundness", m_rightEdgeRoundness);
+
+    themeGroup.writeEntry("bottomEdgeMaxOpacity", m_bottomEdgeMaxOpacity);
+    themeGroup.writeEntry("leftEdgeMaxOpacity", m_leftEdgeMaxOpacity);
+    themeGroup.writeEntry("topEdgeMaxOpacity", m_topEdgeMaxOpacity);
+    themeGroup.writeEntry("rightEdgeMaxOpacity", m_rightEdgeMaxOpacity);
+}
+
 void Theme::loadRoundness()
 {
-    loadCompositingRoundness();
+    //! rasterizing the panel background is expensive, so its results are reused
+    //! for as long as the theme and its panel background remain the same
+    QByteArray signature = panelBackgroundSignature();
+
+    if (!loadCachedRoundness(signature)) {
+        loadCompositingRoundness();
+        saveCachedRoundness(signature);
+    }
 
     emit maxOpacityChanged();
     emit roundnessChanged();
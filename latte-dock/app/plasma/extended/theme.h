@@ -114,6 +114,10 @@ private:
     void loadRoundness();
     void loadCompositingRoundness();
 
+    bool loadCachedRoundness(const QByteArray &signature);
+    void saveCachedRoundness(const QByteArray &signature);
+    QByteArray panelBackgroundSignature() const;
+
     void setOriginalSchemeFile(const QString &file);
     void parseThemeSvgFiles();
     void updateDefaultScheme();
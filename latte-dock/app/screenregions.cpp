@@ -0,0 +1,408 @@
+/*
+ * Copyright 2020  Michail Vourlakos <mvourlakos@gmail.com>
+ *
+ * This file is part of Latte-Dock
+ *
+ * Latte-Dock is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Latte-Dock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "screenregions.h"
+
+// local
+#include "lattecorona.h"
+#include "layout/centrallayout.h"
+#include "view/view.h"
+#include "view/visibilitymanager.h"
+
+// Plasma
+#include <Plasma/Containment>
+
+namespace Latte {
+
+bool ScreenRegions::Criteria::operator==(const Criteria &other) const
+{
+    return screen == other.screen
+            && layout == other.layout
+            && ignoreModes == other.ignoreModes
+            && ignoreEdges == other.ignoreEdges
+            && ignoreExternalPanels == other.ignoreExternalPanels
+            && desktopUse == other.desktopUse;
+}
+
+uint qHash(const ScreenRegions::Criteria &criteria, uint seed)
+{
+    uint flags = (criteria.ignoreExternalPanels ? 1 : 0) | (criteria.desktopUse ? 2 : 0);
+
+    return qHash(criteria.screen, seed) ^ qHash(criteria.layout, seed)
+            ^ qHash(criteria.ignoreModes, seed) ^ qHash(criteria.ignoreEdges << 2 | flags, seed);
+}
+
+ScreenRegions::ScreenRegions(Latte::Corona *corona)
+    : QObject(corona),
+      m_corona(corona)
+{
+    //! these connections are created before any consumer of these signals exists, so
+    //! results are always invalidated before consumers query them again
+    connect(m_corona, &Latte::Corona::availableScreenRectChangedFrom, this, &ScreenRegions::invalidate);
+    connect(m_corona, &Latte::Corona::availableScreenRegionChangedFrom, this, &ScreenRegions::invalidate);
+    connect(m_corona, &Plasma::Corona::availableScreenRectChanged, this, &ScreenRegions::invalidate);
+    connect(m_corona, &Plasma::Corona::availableScreenRegionChanged, this, &ScreenRegions::invalidate);
+}
+
+ScreenRegions::~ScreenRegions()
+{
+    for (const auto &connections : m_viewConnections) {
+        for (const auto &connection : connections) {
+            disconnect(connection);
+        }
+    }
+}
+
+ScreenRegions::Criteria ScreenRegions::criteria(const QScreen *screen,
+                                                const CentralLayout *layout,
+                                                const QList<Types::Visibility> &ignoreModes,
+                                                const QList<Plasma::Types::Location> &ignoreEdges,
+                                                bool ignoreExternalPanels,
+                                                bool desktopUse)
+{
+    Criteria result;
+    result.screen = screen;
+    result.layout = layout;
+    result.ignoreExternalPanels = ignoreExternalPanels;
+    result.desktopUse = desktopUse;
+
+    //! visibility modes start from None(-1)
+    for (const auto mode : ignoreModes) {
+        result.ignoreModes |= (1u << (static_cast<int>(mode) + 1));
+    }
+
+    for (const auto edge : ignoreEdges) {
+        result.ignoreEdges |= (1u << static_cast<int>(edge));
+    }
+
+    return result;
+}
+
+bool ScreenRegions::hasRegion(const Criteria &criteria) const
+{
+    return m_regions.contains(criteria.screen) && m_regions[criteria.screen].contains(criteria);
+}
+
+QRegion ScreenRegions::region(const Criteria &criteria) const
+{
+    return hasRegion(criteria) ? m_regions[criteria.screen][criteria] : QRegion();
+}
+
+void ScreenRegions::setRegion(const Criteria &criteria, const QRegion &region)
+{
+    m_regions[criteria.screen][criteria] = region;
+}
+
+bool ScreenRegions::hasRect(const Criteria &criteria) const
+{
+    return m_rects.contains(criteria.screen) && m_rects[criteria.screen].contains(criteria);
+}
+
+QRect ScreenRegions::rect(const Criteria &criteria) const
+{
+    return hasRect(criteria) ? m_rects[criteria.screen][criteria] : QRect();
+}
+
+void ScreenRegions::setRect(const Criteria &criteria, const QRect &rect)
+{
+    m_rects[criteria.screen][criteria] = rect;
+}
+
+void ScreenRegions::invalidate()
+{
+    m_regions.clear();
+    m_rects.clear();
+    m_bands.clear();
+    m_desktopBands.clear();
+}
+
+void ScreenRegions::invalidateScreen(const QScreen *screen)
+{
+    if (!screen) {
+        return;
+    }
+
+    m_regions.remove(screen);
+    m_rects.remove(screen);
+
+    //! desktop bands depend on screen geometry
+    for (auto it = m_viewScreens.constBegin(); it != m_viewScreens.constEnd(); ++it) {
+        if (it.value() == screen) {
+            m_bands.remove(it.key());
+            m_desktopBands.remove(it.key());
+        }
+    }
+}
+
+void ScreenRegions::invalidateView(Latte::View *view)
+{
+    m_bands.remove(view);
+    m_desktopBands.remove(view);
+
+    invalidateScreen(m_viewScreens.value(view, nullptr));
+
+    if (view->screen() != m_viewScreens.value(view, nullptr)) {
+        invalidateScreen(view->screen());
+        m_viewScreens[view] = view->screen();
+    }
+}
+
+void ScreenRegions::track(CentralLayout *layout, const QScreen *screen, const QList<Latte::View *> &views)
+{
+    if (layout && !m_trackedLayouts.contains(layout)) {
+        m_trackedLayouts << layout;
+
+        //! views were added or removed
+        connect(layout, &GenericLayout::viewsCountChanged, this, &ScreenRegions::invalidate);
+        connect(layout, &QObject::destroyed, this, [this, layout]() {
+            m_trackedLayouts.remove(layout);
+            invalidate();
+        });
+    }
+
+    if (screen && !m_trackedScreens.contains(screen)) {
+        m_trackedScreens << screen;
+
+        connect(screen, &QScreen::geometryChanged, this, [this, screen]() {
+            invalidateScreen(screen);
+        });
+        connect(screen, &QScreen::availableGeometryChanged, this, [this, screen]() {
+            invalidateScreen(screen);
+        });
+        connect(screen, &QObject::destroyed, this, [this, screen]() {
+            m_trackedScreens.remove(screen);
+            invalidate();
+        });
+    }
+
+    for (auto *view : views) {
+        if (view && !m_viewConnections.contains(view)) {
+            trackView(view);
+        }
+    }
+}
+
+void ScreenRegions::trackView(Latte::View *view)
+{
+    QList<QMetaObject::Connection> connections;
+    auto invalidateThisView = [this, view]() {
+        invalidateView(view);
+    };
+
+    m_viewScreens[view] = view->screen();
+
+    connections << connect(view, &QWindow::xChanged, this, invalidateThisView);
+    connections << connect(view, &QWindow::yChanged, this, invalidateThisView);
+    connections << connect(view, &QWindow::widthChanged, this, invalidateThisView);
+    connections << connect(view, &QWindow::heightChanged, this, invalidateThisView);
+    connections << connect(view, &QWindow::screenChanged, this, invalidateThisView);
+
+    connections << connect(view, &View::absoluteGeometryChanged, this, invalidateThisView);
+    connections << connect(view, &View::alignmentChanged, this, invalidateThisView);
+    connections << connect(view, &View::behaveAsPlasmaPanelChanged, this, invalidateThisView);
+    connections << connect(view, &View::maxLengthChanged, this, invalidateThisView);
+    connections << connect(view, &View::normalThicknessChanged, this, invalidateThisView);
+    connections << connect(view, &View::offsetChanged, this, invalidateThisView);
+    connections << connect(view, &View::screenEdgeMarginChanged, this, invalidateThisView);
+    connections << connect(view, &View::screenEdgeMarginEnabledChanged, this, invalidateThisView);
+
+    connections << connect(view, &PlasmaQuick::ContainmentView::locationChanged, this, invalidateThisView);
+    connections << connect(view, &PlasmaQuick::ContainmentView::formFactorChanged, this, invalidateThisView);
+    connections << connect(view, &PlasmaQuick::ContainmentView::containmentChanged, this, invalidateThisView);
+
+    if (view->visibility()) {
+        connections << connect(view->visibility(), &ViewPart::VisibilityManager::modeChanged, this, invalidateThisView);
+    }
+
+    //! the visibility manager is tracked again the next time the view is considered
+    connections << connect(view, &View::visibilityChanged, this, [this, view]() {
+        invalidateView(view);
+        untrackView(view);
+    });
+
+    connections << connect(view, &QObject::destroyed, this, [this, view]() {
+        untrackView(view);
+        invalidate();
+    });
+
+    m_viewConnections[view] = connections;
+}
+
+void ScreenRegions::untrackView(Latte::View *view)
+{
+    if (!m_viewConnections.contains(view)) {
+        return;
+    }
+
+    const QList<QMetaObject::Connection> connections = m_viewConnections.take(view);
+
+    for (const auto &connection : connections) {
+        disconnect(connection);
+    }
+
+    m_viewScreens.remove(view);
+    m_bands.remove(view);
+    m_desktopBands.remove(view);
+}
+
+QRect ScreenRegions::viewBand(Latte::View *view, bool desktopUse)
+{
+    QHash<Latte::View *, QRect> &bands = desktopUse ? m_desktopBands : m_bands;
+
+    if (!bands.contains(view)) {
+        bands[view] = computeViewBand(view, desktopUse);
+    }
+
+    return bands[view];
+}
+
+QRect ScreenRegions::computeViewBand(Latte::View *view, bool desktopUse) const
+{
+    int realThickness = view->normalThickness();
+
+    int x = 0; int y = 0; int w = 0; int h = 0;
+
+    switch (view->formFactor()) {
+    case Plasma::Types::Horizontal:
+        if (view->behaveAsPlasmaPanel()) {
+            w = view->width();
+            x = view->x();
+        } else {
+            w = view->maxLength() * view->width();
+            int offsetW = view->offset() * view->width();
+
+            switch (view->alignment()) {
+            case Latte::Types::Left:
+                x = view->x() + offsetW;
+                break;
+
+            case Latte::Types::Center:
+            case Latte::Types::Justify:
+                x = (view->geometry().center().x() - w/2) + offsetW;
+                break;
+
+            case Latte::Types::Right:
+                x = view->geometry().right() - w - offsetW;
+                break;
+            }
+        }
+        break;
+    case Plasma::Types::Vertical:
+        if (view->behaveAsPlasmaPanel()) {
+            h = view->height();
+            y = view->y();
+        } else {
+            h = view->maxLength() * view->height();
+            int offsetH = view->offset() * view->height();
+
+            switch (view->alignment()) {
+            case Latte::Types::Top:
+                y = view->y() + offsetH;
+                break;
+
+            case Latte::Types::Center:
+            case Latte::Types::Justify:
+                y = (view->geometry().center().y() - h/2) + offsetH;
+                break;
+
+            case Latte::Types::Bottom:
+                y = view->geometry().bottom() - h - offsetH;
+                break;
+            }
+        }
+        break;
+    default:
+        break;
+    }
+
+    // Usually availableScreenRect is used by the desktop,
+    // but Latte don't have desktop, then here just
+    // need calculate available space for top and bottom location,
+    // because the left and right are those who dodge others views
+    switch (view->location()) {
+    case Plasma::Types::TopEdge:
+        if (view->behaveAsPlasmaPanel()) {
+            QRect viewGeometry = view->geometry();
+
+            if (desktopUse) {
+                //! ignore any real window slide outs in all cases
+                viewGeometry.moveTop(view->screen()->geometry().top() + view->screenEdgeMargin());
+            }
+
+            return viewGeometry;
+        }
+
+        y = view->y();
+        return QRect(x, y, w, realThickness);
+
+    case Plasma::Types::BottomEdge:
+        if (view->behaveAsPlasmaPanel()) {
+            QRect viewGeometry = view->geometry();
+
+            if (desktopUse) {
+                //! ignore any real window slide outs in all cases
+                viewGeometry.moveTop(view->screen()->geometry().bottom() - view->screenEdgeMargin() - viewGeometry.height());
+            }
+
+            return viewGeometry;
+        }
+
+        y = view->geometry().bottom() - realThickness + 1;
+        return QRect(x, y, w, realThickness);
+
+    case Plasma::Types::LeftEdge:
+        if (view->behaveAsPlasmaPanel()) {
+            QRect viewGeometry = view->geometry();
+
+            if (desktopUse) {
+                //! ignore any real window slide outs in all cases
+                viewGeometry.moveLeft(view->screen()->geometry().left() + view->screenEdgeMargin());
+            }
+
+            return viewGeometry;
+        }
+
+        x = view->x();
+        return QRect(x, y, realThickness, h);
+
+    case Plasma::Types::RightEdge:
+        if (view->behaveAsPlasmaPanel()) {
+            QRect viewGeometry = view->geometry();
+
+            if (desktopUse) {
+                //! ignore any real window slide outs in all cases
+                viewGeometry.moveLeft(view->screen()->geometry().right() - view->screenEdgeMargin() - viewGeometry.width());
+            }
+
+            return viewGeometry;
+        }
+
+        x = view->geometry().right() - realThickness + 1;
+        return QRect(x, y, realThickness, h);
+
+    default:
+        //! bypass clang warnings
+        break;
+    }
+
+    return QRect();
+}
+
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2020  Michail Vourlakos <mvourlakos@gmail.com>
+ *
+ * This file is part of Latte-Dock
+ *
+ * Latte-Dock is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Latte-Dock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SCREENREGIONS_H
+#define SCREENREGIONS_H
+
+// local
+#include <coretypes.h>
+
+// Qt
+#include <QHash>
+#include <QList>
+#include <QMetaObject>
+#include <QObject>
+#include <QRect>
+#include <QRegion>
+#include <QScreen>
+#include <QSet>
+
+// Plasma
+#include <Plasma>
+
+namespace Latte {
+class CentralLayout;
+class Corona;
+class View;
+}
+
+namespace Latte {
+
+//! Memoizes the available screen regions and rects that Corona computes from its views.
+//! Results are stored per screen and are invalidated only for the screens that are
+//! affected when a tracked view, layout or screen changes. All results are invalidated
+//! when Corona announces that the available screen rects or regions changed. Views areas that are
+//! subtracted from the screen, their edge bands, are also cached per view and they
+//! are reused between the different criteria.
+class ScreenRegions : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Criteria {
+        const QScreen *screen{nullptr};
+        const CentralLayout *layout{nullptr};
+        quint32 ignoreModes{0};
+        quint32 ignoreEdges{0};
+        bool ignoreExternalPanels{true};
+        bool desktopUse{false};
+
+        bool operator==(const Criteria &other) const;
+    };
+
+    ScreenRegions(Latte::Corona *corona);
+    ~ScreenRegions() override;
+
+    static Criteria criteria(const QScreen *screen,
+                             const CentralLayout *layout,
+                             const QList<Types::Visibility> &ignoreModes,
+                             const QList<Plasma::Types::Location> &ignoreEdges,
+                             bool ignoreExternalPanels,
+                             bool desktopUse);
+
+    bool hasRegion(const Criteria &criteria) const;
+    QRegion region(const Criteria &criteria) const;
+    void setRegion(const Criteria &criteria, const QRegion &region);
+
+    bool hasRect(const Criteria &criteria) const;
+    QRect rect(const Criteria &criteria) const;
+    void setRect(const Criteria &criteria, const QRect &rect);
+
+    //! the view area that is subtracted from the available screen region
+    QRect viewBand(Latte::View *view, bool desktopUse);
+
+    //! changes of the tracked layout, screen and views invalidate the relevant results
+    void track(CentralLayout *layout, const QScreen *screen, const QList<Latte::View *> &views);
+
+public slots:
+    void invalidate();
+
+private:
+    void invalidateScreen(const QScreen *screen);
+    void invalidateView(Latte::View *view);
+    void trackView(Latte::View *view);
+    void untrackView(Latte::View *view);
+
+    QRect computeViewBand(Latte::View *view, bool desktopUse) const;
+
+private:
+    QHash<const QScreen *, QHash<Criteria, QRegion>> m_regions;
+    QHash<const QScreen *, QHash<Criteria, QRect>> m_rects;
+
+    //! view edge bands for normal and desktop use
+    QHash<Latte::View *, QRect> m_bands;
+    QHash<Latte::View *, QRect> m_desktopBands;
+
+    //! screen each tracked view was found at, in order to invalidate it when the view moves
+    QHash<Latte::View *, const QScreen *> m_viewScreens;
+    QHash<Latte::View *, QList<QMetaObject::Connection>> m_viewConnections;
+
+    QSet<const QScreen *> m_trackedScreens;
+    QSet<const CentralLayout *> m_trackedLayouts;
+
+    Latte::Corona *m_corona{nullptr};
+};
+
+uint qHash(const ScreenRegions::Criteria &criteria, uint seed = 0);
+
+}
+
+#endif
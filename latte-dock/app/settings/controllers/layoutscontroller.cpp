@@ -33,6 +33,7 @@
 #include "../handlers/tablayoutshandler.h"
 #include "../tools/settingstools.h"
 #include "../../layout/genericlayout.h"
+#include "../../layout/integrityscanner.h"
 #include "../../layout/centrallayout.h"
 #include "../../layout/sharedlayout.h"
 #include "../../layouts/importer.h"
@@ -42,6 +43,7 @@
 // Qt
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QHeaderView>
 #include <QItemSelection>
 #include <QStringList>
@@ -51,6 +53,8 @@
 #include <KArchive/KTar>
 #include <KArchive/KArchiveEntry>
 #include <KArchive/KArchiveDirectory>
+#include <KConfig>
+#include <KConfigGroup>
 #include <KMessageWidget>
 
 namespace Latte {
@@ -237,6 +241,15 @@ void Layouts::updateLastColumnWidth()
     }
 }
 
+CentralLayout *Layouts::centralLayout(const QString &id)
+{
+    if (!m_layouts.contains(id)) {
+        m_layouts[id] = new CentralLayout(this, id);
+    }
+
+    return m_layouts[id];
+}
+
 int Layouts::rowForId(QString id) const
 {
     for (int i = 0; i < m_proxyModel->rowCount(); ++i) {
@@ -399,27 +412,56 @@ void Layouts::loadLayouts()
 
     Settings::Data::LayoutsTable layoutsBuffer;
 
+    //! layout files are scanned in parallel for their ids integrity, the settings rows are
+    //! built from their LayoutSettings and full layouts are created only when they are needed
+    QStringList layoutFiles;
+
+    for (const auto layout : m_handler->corona()->layoutsManager()->layouts()) {
+        layoutFiles << QDir::homePath() + "/.config/latte/" + layout + ".layout.latte";
+    }
+
+    Latte::Layout::IntegrityScanner::self()->prefetch(layoutFiles);
+
     for (const auto layout : m_handler->corona()->layoutsManager()->layouts()) {
         Settings::Data::Layout original;
         original.id = QDir::homePath() + "/.config/latte/" + layout + ".layout.latte";
+        original.name = layout;
+
+        Latte::Layout::IntegrityReport report = Latte::Layout::IntegrityScanner::self()->scan(original.id);
+        CentralLayout *centralActive = m_handler->corona()->layoutsManager()->synchronizer()->centralLayout(layout);
+        QString shared;
+
+        if (centralActive) {
+            original.backgroundStyle = centralActive->backgroundStyle();
+            original.color = centralActive->color();
+            original.background = centralActive->customBackground();
+            original.textColor = centralActive->customTextColor();
+            original.isShownInMenu = centralActive->showInMenu();
+            original.hasDisabledBorders = centralActive->disableBordersForMaximizedWindows();
+            original.activities = centralActive->activities();
+            shared = centralActive->sharedLayoutName();
+        } else {
+            //! the same reader the layouts use when they are loaded
+            KConfig layoutConfig(original.id, KConfig::SimpleConfig);
+            Latte::Layout::StoredSettings settings;
+            CentralLayout::readSettings(KConfigGroup(&layoutConfig, "LayoutSettings"), settings);
+
+            original.backgroundStyle = settings.backgroundStyle;
+            original.color = settings.color;
+            original.background = settings.customBackground;
+            original.textColor = settings.customTextColor;
+            original.isShownInMenu = settings.showInMenu;
+            original.hasDisabledBorders = settings.disableBordersForMaximizedWindows;
+            original.activities = settings.activities;
+            shared = settings.sharedLayoutName;
+        }
 
-        CentralLayout *central = new CentralLayout(this, original.id);
-
-        original.name = central->name();
-        original.backgroundStyle = central->backgroundStyle();
-        original.color = central->color();
-        original.background = central->customBackground();
-        original.textColor = central->customTextColor();
         original.isActive = (m_handler->corona()->layoutsManager()->synchronizer()->layout(original.name) != nullptr);
-        original.isLocked = !central->isWritable();
-        original.isShownInMenu = central->showInMenu();
-        original.hasDisabledBorders = central->disableBordersForMaximizedWindows();
-        original.activities = central->activities();
 
-        m_layouts[original.id] = central;
+        QFileInfo layoutFileInfo(original.id);
+        original.isLocked = (layoutFileInfo.exists() && !layoutFileInfo.isWritable());
 
         //! create initial SHARES maps
-        QString shared = central->sharedLayoutName();
         if (!shared.isEmpty()) {
             sharesMap[shared].append(original.id);
         }
@@ -430,10 +472,17 @@ void Layouts::loadLayouts()
 
         i++;
 
-        Latte::Layout::GenericLayout *generic = m_handler->corona()->layoutsManager()->synchronizer()->layout(central->name());
+        Latte::Layout::GenericLayout *generic = m_handler->corona()->layoutsManager()->synchronizer()->layout(original.name);
 
-        if ((generic && generic->layoutIsBroken()) || (!generic && central->layoutIsBroken())) {
-            brokenLayouts.append(central->name());
+        if (generic) {
+            if (generic->layoutIsBroken()) {
+                brokenLayouts.append(original.name);
+            }
+        } else if (report.hasDeprecatedApplets || report.hasDuplicatedIds()) {
+            //! the full layout heals its deprecated applets and reports the broken ids in detail
+            if (centralLayout(original.id)->layoutIsBroken()) {
+                brokenLayouts.append(original.name);
+            }
         }
     }
 
@@ -716,7 +765,7 @@ void Layouts::save()
         //! update the generic parts of the layouts
         bool isOriginalLayout = m_model->originalLayoutsData().containsId(iLayoutCurrentData.id);
         Latte::Layout::GenericLayout *genericActive= isOriginalLayout ? m_handler->corona()->layoutsManager()->synchronizer()->layout(iLayoutOriginalData.name) : nullptr;
-        Latte::Layout::GenericLayout *generic = genericActive ? genericActive : m_layouts[iLayoutCurrentData.id];
+        Latte::Layout::GenericLayout *generic = genericActive ? genericActive : centralLayout(iLayoutCurrentData.id);
 
         //! unlock read-only layout
         if (!generic->isWritable()) {
@@ -742,7 +791,7 @@ void Layouts::save()
 
         //! update only the Central-specific layout parts
         CentralLayout *centralActive = isOriginalLayout ? m_handler->corona()->layoutsManager()->synchronizer()->centralLayout(iLayoutOriginalData.name) : nullptr;
-        CentralLayout *central = centralActive ? centralActive : m_layouts[iLayoutCurrentData.id];
+        CentralLayout *central = centralActive ? centralActive : centralLayout(iLayoutCurrentData.id);
 
         if (central->showInMenu() != iLayoutCurrentData.isShownInMenu) {
             central->setShowInMenu(iLayoutCurrentData.isShownInMenu);
@@ -116,6 +116,9 @@ private:
     void initView();
     void syncActiveShares();
 
+    //! layouts that are not active are loaded only when they are needed
+    Latte::CentralLayout *centralLayout(const QString &id);
+
     int rowForId(QString id) const;
     int rowForName(QString layoutName) const;
 
@@ -58,11 +58,14 @@ UniversalSettings::UniversalSettings(KSharedConfig::Ptr config, QObject *parent)
     connect(this, &UniversalSettings::launchersChanged, this, &UniversalSettings::saveConfig);
     connect(this, &UniversalSettings::layoutsMemoryUsageChanged, this, &UniversalSettings::saveConfig);
     connect(this, &UniversalSettings::hiddenConfigurationWindowsAreDeletedChanged, this, &UniversalSettings::saveConfig);
+    connect(this, &UniversalSettings::lazyViewsChanged, this, &UniversalSettings::saveConfig);
     connect(this, &UniversalSettings::metaPressAndHoldEnabledChanged, this, &UniversalSettings::saveConfig);
     connect(this, &UniversalSettings::sensitivityChanged, this, &UniversalSettings::saveConfig);
     connect(this, &UniversalSettings::screenTrackerIntervalChanged, this, &UniversalSettings::saveConfig);
     connect(this, &UniversalSettings::showInfoWindowChanged, this, &UniversalSettings::saveConfig);
     connect(this, &UniversalSettings::versionChanged, this, &UniversalSettings::saveConfig);
+    connect(this, &UniversalSettings::warmLayoutsChanged, this, &UniversalSettings::saveConfig);
+    connect(this, &UniversalSettings::warmLayoutsMemoryBudgetChanged, this, &UniversalSettings::saveConfig);
 
     connect(this, &UniversalSettings::screenScalesChanged, this, &UniversalSettings::saveScalesConfig);
 
@@ -163,6 +166,36 @@ void UniversalSettings::setScreenTrackerInterval(int duration)
     emit screenTrackerIntervalChanged();
 }
 
+int UniversalSettings::warmLayouts() const
+{
+    return m_warmLayouts;
+}
+
+void UniversalSettings::setWarmLayouts(int count)
+{
+    if (m_warmLayouts == count) {
+        return;
+    }
+
+    m_warmLayouts = count;
+    emit warmLayoutsChanged();
+}
+
+int UniversalSettings::warmLayoutsMemoryBudget() const
+{
+    return m_warmLayoutsMemoryBudget;
+}
+
+void UniversalSettings::setWarmLayoutsMemoryBudget(int budget)
+{
+    if (m_warmLayoutsMemoryBudget == budget) {
+        return;
+    }
+
+    m_warmLayoutsMemoryBudget = budget;
+    emit warmLayoutsMemoryBudgetChanged();
+}
+
 QString UniversalSettings::currentLayoutName() const
 {
     return m_currentLayoutName;
@@ -410,6 +443,21 @@ void UniversalSettings::setHiddenConfigurationWindowsAreDeleted(bool enabled)
     emit hiddenConfigurationWindowsAreDeletedChanged();
 }
 
+bool UniversalSettings::lazyViews() const
+{
+    return m_lazyViews;
+}
+
+void UniversalSettings::setLazyViews(bool enabled)
+{
+    if (m_lazyViews == enabled) {
+        return;
+    }
+
+    m_lazyViews = enabled;
+    emit lazyViewsChanged();
+}
+
 bool UniversalSettings::metaPressAndHoldEnabled() const
 {
     return m_metaPressAndHoldEnabled;
@@ -501,9 +549,12 @@ void UniversalSettings::loadConfig()
     m_lastNonAssignedLayoutName = m_universalGroup.readEntry("lastNonAssignedLayout", QString());
     m_launchers = m_universalGroup.readEntry("launchers", QStringList());
     m_hiddenConfigurationWindowsAreDeleted = m_universalGroup.readEntry("hiddenConfigurationWindowsAreDeleted", true);
+    m_lazyViews = m_universalGroup.readEntry("lazyViews", false);
     m_metaPressAndHoldEnabled = m_universalGroup.readEntry("metaPressAndHoldEnabled", true);
     m_screenTrackerInterval = m_universalGroup.readEntry("screenTrackerInterval", 2500);
     m_showInfoWindow = m_universalGroup.readEntry("showInfoWindow", true);
+    m_warmLayouts = m_universalGroup.readEntry("warmLayouts", 2);
+    m_warmLayoutsMemoryBudget = m_universalGroup.readEntry("warmLayoutsMemoryBudget", 512);
     m_memoryUsage = static_cast<MemoryUsage::LayoutsMemory>(m_universalGroup.readEntry("memoryUsage", (int)MemoryUsage::SingleLayout));
     m_sensitivity = static_cast<Settings::MouseSensitivity>(m_universalGroup.readEntry("mouseSensitivity", (int)Settings::HighMouseSensitivity));
 
@@ -519,9 +570,12 @@ void UniversalSettings::saveConfig()
     m_universalGroup.writeEntry("lastNonAssignedLayout", m_lastNonAssignedLayoutName);
     m_universalGroup.writeEntry("launchers", m_launchers);
     m_universalGroup.writeEntry("hiddenConfigurationWindowsAreDeleted", m_hiddenConfigurationWindowsAreDeleted);
+    m_universalGroup.writeEntry("lazyViews", m_lazyViews);
     m_universalGroup.writeEntry("metaPressAndHoldEnabled", m_metaPressAndHoldEnabled);
     m_universalGroup.writeEntry("screenTrackerInterval", m_screenTrackerInterval);
     m_universalGroup.writeEntry("showInfoWindow", m_showInfoWindow);
+    m_universalGroup.writeEntry("warmLayouts", m_warmLayouts);
+    m_universalGroup.writeEntry("warmLayoutsMemoryBudget", m_warmLayoutsMemoryBudget);
     m_universalGroup.writeEntry("memoryUsage", (int)m_memoryUsage);
     m_universalGroup.writeEntry("mouseSensitivity", (int)m_sensitivity);
 }
@@ -94,6 +94,9 @@ public:
     bool hiddenConfigurationWindowsAreDeleted() const;
     void setHiddenConfigurationWindowsAreDeleted(bool enabled);
 
+    bool lazyViews() const;
+    void setLazyViews(bool enabled);
+
     bool metaPressAndHoldEnabled() const;
     void setMetaPressAndHoldEnabled(bool enabled);
 
@@ -106,6 +109,14 @@ public:
     int screenTrackerInterval() const;
     void setScreenTrackerInterval(int duration);
 
+    //! layouts kept preloaded in MultipleLayouts mode
+    int warmLayouts() const;
+    void setWarmLayouts(int count);
+
+    //! memory budget in MB above which no layouts are kept preloaded
+    int warmLayoutsMemoryBudget() const;
+    void setWarmLayoutsMemoryBudget(int budget);
+
     QString currentLayoutName() const;
     void setCurrentLayoutName(QString layoutName);
 
@@ -143,6 +154,7 @@ signals:
     void layoutsWindowSizeChanged();
     void launchersChanged();
     void layoutsMemoryUsageChanged();
+    void lazyViewsChanged();
     void metaPressAndHoldEnabledChanged();
     void sensitivityChanged();
     void screensCountChanged();
@@ -150,6 +162,8 @@ signals:
     void screenTrackerIntervalChanged();
     void showInfoWindowChanged();
     void versionChanged();
+    void warmLayoutsChanged();
+    void warmLayoutsMemoryBudgetChanged();
 
 private slots:
     void loadConfig();
@@ -174,6 +188,7 @@ private:
     bool m_canDisableBorders{false};
     bool m_colorsScriptIsPresent{false};
     bool m_hiddenConfigurationWindowsAreDeleted{true};
+    bool m_lazyViews{false};
     bool m_metaPressAndHoldEnabled{true};
     bool m_showInfoWindow{true};
 
@@ -186,6 +201,9 @@ private:
 
     int m_screenTrackerInterval{2500};
 
+    int m_warmLayouts{2};
+    int m_warmLayoutsMemoryBudget{512};
+
     QString m_currentLayoutName;
     QString m_lastNonAssignedLayoutName;
 
@@ -25,8 +25,98 @@
 #include <QStandardPaths>
 #include <QtMath>
 
+// C++
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define LATTE_AVX2_DISPATCH
+#endif
+
+#define BRIGHTNESSRED 299
+#define BRIGHTNESSGREEN 587
+#define BRIGHTNESSBLUE 114
+
 namespace Latte {
 
+namespace {
+quint64 colorBrightnessSumScalar(const QRgb *pixels, int count)
+{
+    quint64 sum{0};
+
+    for (int i=0; i<count; ++i) {
+        sum += qRed(pixels[i]) * BRIGHTNESSRED + qGreen(pixels[i]) * BRIGHTNESSGREEN + qBlue(pixels[i]) * BRIGHTNESSBLUE;
+    }
+
+    return sum;
+}
+
+//! Pixels are weighted through 16bit multiply-add. Masking with 0x00FF00FF leaves per pixel
+//! the [blue, red] 16bit pair that is multiplied with [114, 299], and shifting by 8 leaves the
+//! [green, 0] pair that is multiplied with [587, 0]. Per pixel results fit easily in 32bit
+//! and are accumulated in 64bit lanes so any image size is safe.
+#if defined(__SSE2__)
+quint64 colorBrightnessSumSse2(const QRgb *pixels, int count)
+{
+    const __m128i redBlueMask = _mm_set1_epi32(0x00FF00FF);
+    const __m128i greenMask = _mm_set1_epi32(0x000000FF);
+    const __m128i redBlueWeights = _mm_set1_epi32((BRIGHTNESSRED << 16) | BRIGHTNESSBLUE);
+    const __m128i greenWeights = _mm_set1_epi32(BRIGHTNESSGREEN);
+    const __m128i zero = _mm_setzero_si128();
+
+    __m128i sum = _mm_setzero_si128();
+    int i{0};
+
+    for (; i+4 <= count; i += 4) {
+        const __m128i pixel = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + i));
+        const __m128i redBlue = _mm_madd_epi16(_mm_and_si128(pixel, redBlueMask), redBlueWeights);
+        const __m128i green = _mm_madd_epi16(_mm_and_si128(_mm_srli_epi32(pixel, 8), greenMask), greenWeights);
+        const __m128i weighted = _mm_add_epi32(redBlue, green);
+
+        sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(weighted, zero));
+        sum = _mm_add_epi64(sum, _mm_unpackhi_epi32(weighted, zero));
+    }
+
+    quint64 lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), sum);
+
+    return lanes[0] + lanes[1] + colorBrightnessSumScalar(pixels + i, count - i);
+}
+#endif
+
+#if defined(LATTE_AVX2_DISPATCH)
+__attribute__((target("avx2")))
+quint64 colorBrightnessSumAvx2(const QRgb *pixels, int count)
+{
+    const __m256i redBlueMask = _mm256_set1_epi32(0x00FF00FF);
+    const __m256i greenMask = _mm256_set1_epi32(0x000000FF);
+    const __m256i redBlueWeights = _mm256_set1_epi32((BRIGHTNESSRED << 16) | BRIGHTNESSBLUE);
+    const __m256i greenWeights = _mm256_set1_epi32(BRIGHTNESSGREEN);
+    const __m256i zero = _mm256_setzero_si256();
+
+    __m256i sum = _mm256_setzero_si256();
+    int i{0};
+
+    for (; i+8 <= count; i += 8) {
+        const __m256i pixel = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pixels + i));
+        const __m256i redBlue = _mm256_madd_epi16(_mm256_and_si256(pixel, redBlueMask), redBlueWeights);
+        const __m256i green = _mm256_madd_epi16(_mm256_and_si256(_mm256_srli_epi32(pixel, 8), greenMask), greenWeights);
+        const __m256i weighted = _mm256_add_epi32(redBlue, green);
+
+        sum = _mm256_add_epi64(sum, _mm256_unpacklo_epi32(weighted, zero));
+        sum = _mm256_add_epi64(sum, _mm256_unpackhi_epi32(weighted, zero));
+    }
+
+    quint64 lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), sum);
+
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + colorBrightnessSumScalar(pixels + i, count - i);
+}
+#endif
+}
+
 float colorBrightness(QColor color)
 {
     return colorBrightness(color.red(), color.green(), color.blue());
@@ -39,11 +129,28 @@ float colorBrightness(QRgb rgb)
 
 float colorBrightness(float r, float g, float b)
 {
-    float brightness = (r * 299 + g * 587 + b * 114) / 1000;
+    float brightness = (r * BRIGHTNESSRED + g * BRIGHTNESSGREEN + b * BRIGHTNESSBLUE) / 1000;
 
     return brightness;
 }
 
+quint64 colorBrightnessSum(const QRgb *pixels, int count)
+{
+#if defined(LATTE_AVX2_DISPATCH)
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+
+    if (hasAvx2) {
+        return colorBrightnessSumAvx2(pixels, count);
+    }
+#endif
+
+#if defined(__SSE2__)
+    return colorBrightnessSumSse2(pixels, count);
+#else
+    return colorBrightnessSumScalar(pixels, count);
+#endif
+}
+
 
 float colorLumina(QRgb rgb)
 {
@@ -30,6 +30,10 @@ float colorBrightness(QColor color);
 float colorBrightness(QRgb rgb);
 float colorBrightness(float r, float g, float b);
 
+//! returns the sum of colorBrightness()*1000 for all pixels, pixels must be in
+//! Format_RGB32 or Format_ARGB32. It is computed through SSE2/AVX2 when available
+quint64 colorBrightnessSum(const QRgb *pixels, int count);
+
 float colorLumina(QColor color);
 float colorLumina(QRgb rgb);
 float colorLumina(float r, float g, float b);
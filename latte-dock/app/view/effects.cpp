@@ -25,21 +25,25 @@
 #include "panelshadows_p.h"
 #include "view.h"
 
-// Qt
-#include <QRegion>
-
 // KDE
 #include <KWindowEffects>
 #include <KWindowSystem>
 
+#define MAXCACHEDFRAMEMASKS 64
+
 
 namespace Latte {
 namespace ViewPart {
 
 Effects::Effects(Latte::View *parent)
     : QObject(parent),
-      m_view(parent)
+      m_view(parent),
+      m_frameMasks(MAXCACHEDFRAMEMASKS)
 {
+    m_applyMaskTimer.setSingleShot(true);
+    m_applyMaskTimer.setInterval(0);
+    connect(&m_applyMaskTimer, &QTimer::timeout, this, &Effects::applyMask);
+
     init();
 }
 
@@ -71,6 +75,8 @@ void Effects::init()
     connect(m_view, &Latte::View::configWindowGeometryChanged, this, &Effects::updateMask);
 
     connect(&m_theme, &Plasma::Theme::themeChanged, this, [&]() {
+        m_frameMasks.clear();
+
         auto background = m_background;
         m_background = new Plasma::FrameSvg(this);
 
@@ -244,6 +250,7 @@ void Effects::forceMaskRedraw()
     m_background->setImagePath(QStringLiteral("widgets/panel-background"));
     m_background->setEnabledBorders(m_enabledBorders);
 
+    m_frameMasks.clear();
     updateMask();
 }
 
@@ -254,6 +261,7 @@ void Effects::setSubtractedMaskRegion(const QString &regionid, const QRegion &re
     }
 
     m_subtractedMaskRegions[regionid] = region;
+    updateSubtractedMaskRegion();
     emit subtractedMaskRegionsChanged();
 }
 
@@ -264,6 +272,7 @@ void Effects::removeSubtractedMaskRegion(const QString &regionid)
     }
 
     m_subtractedMaskRegions.remove(regionid);
+    updateSubtractedMaskRegion();
     emit subtractedMaskRegionsChanged();
 }
 
@@ -274,6 +283,7 @@ void Effects::setUnitedMaskRegion(const QString &regionid, const QRegion &region
     }
 
     m_unitedMaskRegions[regionid] = region;
+    updateUnitedMaskRegion();
     emit unitedMaskRegionsChanged();
 }
 
@@ -284,61 +294,95 @@ void Effects::removeUnitedMaskRegion(const QString &regionid)
     }
 
     m_unitedMaskRegions.remove(regionid);
+    updateUnitedMaskRegion();
     emit unitedMaskRegionsChanged();
 }
 
-QRegion Effects::maskCombinedRegion()
+void Effects::updateSubtractedMaskRegion()
 {
-    QRegion region = m_mask;
+    m_subtractedMaskRegion = QRegion();
 
     for(auto subregion : m_subtractedMaskRegions) {
-        region = region.subtracted(subregion);
+        m_subtractedMaskRegion += subregion;
     }
+}
+
+void Effects::updateUnitedMaskRegion()
+{
+    m_unitedMaskRegion = QRegion();
 
     for(auto subregion : m_unitedMaskRegions) {
-        region = region.united(subregion);
+        m_unitedMaskRegion += subregion;
     }
+}
+
+QRegion Effects::maskCombinedRegion()
+{
+    return QRegion(m_mask).subtracted(m_subtractedMaskRegion).united(m_unitedMaskRegion);
+}
+
+QRegion Effects::frameMask(const QSize &size)
+{
+    //! enabled borders need only four bits
+    qint64 key = (qint64(size.width()) << 36) | (qint64(size.height()) << 4) | qint64(m_enabledBorders);
+
+    if (QRegion *cached = m_frameMasks.object(key)) {
+        return *cached;
+    }
+
+    if (!m_background) {
+        m_background = new Plasma::FrameSvg(this);
+    }
+
+    if (m_background->imagePath() != "widgets/panel-background") {
+        m_background->setImagePath(QStringLiteral("widgets/panel-background"));
+    }
+
+    //! enabled borders are always set because there were cases that
+    //! the mask region wasn't calculated correctly after location changes
+    m_background->setEnabledBorders(m_enabledBorders);
+    m_background->resizeFrame(size);
+
+    QRegion mask = m_background->mask();
+    m_frameMasks.insert(key, new QRegion(mask));
 
-    return region;
+    return mask;
 }
 
 void Effects::updateMask()
 {
+    if (!m_applyMaskTimer.isActive()) {
+        m_applyMaskTimer.start();
+    }
+}
+
+void Effects::applyMask()
+{
+    if (!m_view) {
+        return;
+    }
+
+    QRegion newMask;
+
     if (KWindowSystem::compositingActive()) {
-        if (m_view->behaveAsPlasmaPanel()) {
-            m_view->setMask(QRect());
-        } else {
-            m_view->setMask(maskCombinedRegion());
+        if (!m_view->behaveAsPlasmaPanel()) {
+            newMask = maskCombinedRegion();
         }
     } else {
         //! this is used when compositing is disabled and provides
         //! the correct way for the mask to be painted in order for
         //! rounded corners to be shown correctly
-        //! the enabledBorders check was added because there was cases
-        //! that the mask region wasn't calculated correctly after location changes
-        if (!m_background) {
-            if (m_background && m_background->enabledBorders() != m_enabledBorders) {
-                delete m_background;
-            }
-
-            m_background = new Plasma::FrameSvg(this);
-        }
-
-        if (m_background->imagePath() != "widgets/panel-background") {
-            m_background->setImagePath(QStringLiteral("widgets/panel-background"));
-        }
-
-        m_background->setEnabledBorders(m_enabledBorders);
-        m_background->resizeFrame(m_mask.size());
-        QRegion fixedMask = m_background->mask();
-        fixedMask.translate(m_mask.x(), m_mask.y());
+        newMask = frameMask(m_mask.size());
+        newMask.translate(m_mask.x(), m_mask.y());
 
         //! fix for KF5.32 that return empty QRegion's for the mask
-        if (fixedMask.isEmpty()) {
-            fixedMask = QRegion(m_mask);
+        if (newMask.isEmpty()) {
+            newMask = QRegion(m_mask);
         }
+    }
 
-        m_view->setMask(fixedMask);
+    if (m_view->mask() != newMask) {
+        m_view->setMask(newMask);
     }
 }
 
@@ -372,18 +416,7 @@ void Effects::updateEffects()
                 //! this is used when compositing is disabled and provides
                 //! the correct way for the mask to be painted in order for
                 //! rounded corners to be shown correctly
-                if (!m_background) {
-                    m_background = new Plasma::FrameSvg(this);
-                }
-
-                if (m_background->imagePath() != "widgets/panel-background") {
-                    m_background->setImagePath(QStringLiteral("widgets/panel-background"));
-                }
-
-                m_background->setEnabledBorders(m_enabledBorders);
-                m_background->resizeFrame(m_rect.size());
-
-                QRegion backMask = m_background->mask();
+                QRegion backMask = frameMask(m_rect.size());
 
                 //! There are cases that mask is NULL even though it should not
                 //! Example: SideBar from v0.10 that BEHAVEASPLASMAPANEL in EditMode
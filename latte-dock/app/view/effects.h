@@ -21,10 +21,13 @@
 #define EFFECTS_H
 
 // Qt
+#include <QCache>
 #include <QObject>
 #include <QPointer>
 #include <QQuickView>
 #include <QRect>
+#include <QRegion>
+#include <QTimer>
 
 // Plasma
 #include <Plasma/FrameSvg>
@@ -123,6 +126,11 @@ private slots:
 private:
     qreal currentMidValue(const qreal &max, const qreal &factor, const qreal &min) const;
     QRegion maskCombinedRegion();
+    QRegion frameMask(const QSize &size);
+
+    void applyMask();
+    void updateSubtractedMaskRegion();
+    void updateUnitedMaskRegion();
 
 private:
     bool m_animationsBlocked{false};
@@ -155,6 +163,17 @@ private:
     //! Subtracted and United Mask regions
     QHash<QString, QRegion> m_subtractedMaskRegions;
     QHash<QString, QRegion> m_unitedMaskRegions;
+
+    //! all subtracted and united regions combined, they are recomputed only
+    //! when the regions change and not for every mask change
+    QRegion m_subtractedMaskRegion;
+    QRegion m_unitedMaskRegion;
+
+    //! frame masks for disabled compositing based on their size and enabled borders
+    QCache<qint64, QRegion> m_frameMasks;
+
+    //! all mask changes during the same event loop pass are applied once
+    QTimer m_applyMaskTimer;
 };
 
 }
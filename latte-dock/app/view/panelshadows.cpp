@@ -18,6 +18,7 @@
 
 #include "panelshadows_p.h"
 
+#include <QCryptographicHash>
 #include <QWindow>
 #include <QPainter>
 
@@ -40,14 +41,127 @@
 
 #include <qdebug.h>
 
+#if HAVE_X11
+//! X11 pixmaps of shadow tiles are shared between all PanelShadows instances, their
+//! border masks and windows. Tiles are identified by their contents, so each unique
+//! tile is uploaded to the X server only once.
+class ShadowTilesAtlas
+{
+public:
+    Qt::HANDLE acquire(const QPixmap &source);
+    void release(Qt::HANDLE pixmap);
+
+private:
+    Qt::HANDLE createPixmap(const QImage &image);
+
+    struct Tile {
+        Qt::HANDLE pixmap{nullptr};
+        int references{0};
+    };
+
+    //! xcb connection
+    xcb_connection_t* _connection{nullptr};
+
+    //! graphical context
+    xcb_gcontext_t _gc{0x0};
+
+    QHash<QByteArray, Tile> m_tiles;
+    QHash<Qt::HANDLE, QByteArray> m_tileKeys;
+};
+
+Q_GLOBAL_STATIC(ShadowTilesAtlas, shadowTilesAtlas)
+
+Qt::HANDLE ShadowTilesAtlas::acquire(const QPixmap &source)
+{
+    // do nothing for invalid pixmaps
+    if (source.isNull()) {
+        return nullptr;
+    }
+
+    QImage image(source.toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied));
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(reinterpret_cast<const char *>(image.constBits()), image.byteCount());
+    QByteArray key = QByteArray::number(image.width()) + "x" + QByteArray::number(image.height()) + hash.result();
+
+    if (!m_tiles.contains(key)) {
+        Tile tile;
+        tile.pixmap = createPixmap(image);
+
+        if (!tile.pixmap) {
+            return nullptr;
+        }
+
+        m_tiles[key] = tile;
+        m_tileKeys[tile.pixmap] = key;
+    }
+
+    m_tiles[key].references++;
+    return m_tiles[key].pixmap;
+}
+
+void ShadowTilesAtlas::release(Qt::HANDLE pixmap)
+{
+    if (!pixmap || !m_tileKeys.contains(pixmap)) {
+        return;
+    }
+
+    QByteArray key = m_tileKeys[pixmap];
+
+    if (--m_tiles[key].references > 0) {
+        return;
+    }
+
+    m_tiles.remove(key);
+    m_tileKeys.remove(pixmap);
+
+    auto *display = QX11Info::display();
+
+    if (display) {
+        XFreePixmap(display, reinterpret_cast<unsigned long>(pixmap));
+    }
+}
+
+Qt::HANDLE ShadowTilesAtlas::createPixmap(const QImage &image)
+{
+    /*
+    in some cases, pixmap handle is invalid. This is the case notably
+    when Qt uses to RasterEngine. In this case, we create an X11 Pixmap
+    explicitly and draw the source pixmap on it.
+    */
+
+    // check connection
+    if( !_connection ) _connection = QX11Info::connection();
+
+    const int width( image.width() );
+    const int height( image.height() );
+
+    // create X11 pixmap
+    Pixmap pixmap = XCreatePixmap( QX11Info::display(), QX11Info::appRootWindow(), width, height, 32 );
+
+    // check gc
+    if( !_gc )
+    {
+        _gc = xcb_generate_id( _connection );
+        xcb_create_gc( _connection, _gc, pixmap, 0, nullptr );
+    }
+
+    xcb_put_image(
+        _connection, XCB_IMAGE_FORMAT_Z_PIXMAP, pixmap, _gc,
+        image.width(), image.height(), 0, 0,
+        0, 32,
+        image.byteCount(), image.constBits());
+
+    return (Qt::HANDLE)pixmap;
+}
+#endif
+
 class PanelShadows::Private
 {
 public:
     Private(PanelShadows *shadows)
         : q(shadows)
 #if HAVE_X11
-        ,_connection( nullptr ),
-        _gc( 0x0 )
         , m_isX11(KWindowSystem::isPlatformX11())
 #endif
     {
@@ -65,7 +179,7 @@ public:
     void freeWaylandBuffers();
     void clearPixmaps();
     void setupPixmaps();
-    Qt::HANDLE createPixmap(const QPixmap& source);
+    Qt::HANDLE x11Pixmap(const QPixmap &source);
     void initPixmap(const QString &element);
     QPixmap initEmptyPixmap(const QSize &size);
     void updateShadow(const QWindow *window, Plasma::FrameSvg::EnabledBorders);
@@ -92,12 +206,10 @@ public:
     QPixmap m_emptyHorizontalPix;
 
 #if HAVE_X11
-    //! xcb connection
-    xcb_connection_t* _connection;
-
-    //! graphical context
-    xcb_gcontext_t _gc;
     bool m_isX11;
+
+    //! pixmap cache key and its shared X11 tile
+    QHash<qint64, Qt::HANDLE> m_x11Pixmaps;
 #endif
 
     struct Wayland {
@@ -194,6 +306,13 @@ void PanelShadows::Private::updateShadows()
 {
     const bool hadShadowsBefore = !m_shadowPixmaps.isEmpty();
 
+#if HAVE_X11
+    //! previous tiles are released only after the new ones have been acquired,
+    //! this way tiles that did not change are not uploaded again
+    const QList<Qt::HANDLE> previousTiles = m_x11Pixmaps.values();
+    m_x11Pixmaps.clear();
+#endif
+
     // has shadows now?
     if (hasShadows()) {
         if (hadShadowsBefore) {
@@ -210,66 +329,32 @@ void PanelShadows::Private::updateShadows()
             clearPixmaps();
         }
     }
+
+#if HAVE_X11
+    if (m_isX11 && !shadowTilesAtlas.isDestroyed()) {
+        for (const auto tile : previousTiles) {
+            shadowTilesAtlas->release(tile);
+        }
+    }
+#endif
 }
 
-Qt::HANDLE PanelShadows::Private::createPixmap(const QPixmap& source)
+Qt::HANDLE PanelShadows::Private::x11Pixmap(const QPixmap &source)
 {
-
-    // do nothing for invalid pixmaps
-    if( source.isNull() ) return nullptr;
-
-    /*
-    in some cases, pixmap handle is invalid. This is the case notably
-    when Qt uses to RasterEngine. In this case, we create an X11 Pixmap
-    explicitly and draw the source pixmap on it.
-    */
-
-    #if HAVE_X11
-    if (!m_isX11) {
+#if HAVE_X11
+    if (!m_isX11 || source.isNull()) {
         return nullptr;
     }
 
-    // check connection
-    if( !_connection ) _connection = QX11Info::connection();
-
-    const int width( source.width() );
-    const int height( source.height() );
-
-    // create X11 pixmap
-    Pixmap pixmap = XCreatePixmap( QX11Info::display(), QX11Info::appRootWindow(), width, height, 32 );
-
-    // check gc
-    if( !_gc )
-    {
-        _gc = xcb_generate_id( _connection );
-        xcb_create_gc( _connection, _gc, pixmap, 0, nullptr );
+    if (!m_x11Pixmaps.contains(source.cacheKey())) {
+        m_x11Pixmaps[source.cacheKey()] = shadowTilesAtlas->acquire(source);
     }
 
-//         // create explicitly shared QPixmap from it
-//         QPixmap dest( QPixmap::fromX11Pixmap( pixmap, QPixmap::ExplicitlyShared ) );
-//
-//         // create surface for pixmap
-//         {
-//             QPainter painter( &dest );
-//             painter.setCompositionMode( QPainter::CompositionMode_Source );
-//             painter.drawPixmap( 0, 0, source );
-//         }
-//
-//
-//         return pixmap;
-    QImage image( source.toImage() );
-    xcb_put_image(
-        _connection, XCB_IMAGE_FORMAT_Z_PIXMAP, pixmap, _gc,
-        image.width(), image.height(), 0, 0,
-        0, 32,
-        image.byteCount(), image.constBits());
-
-    return (Qt::HANDLE)pixmap;
-
-    #else
-    return 0;
-    #endif
-
+    return m_x11Pixmaps[source.cacheKey()];
+#else
+    Q_UNUSED(source)
+    return nullptr;
+#endif
 }
 
 void PanelShadows::Private::initPixmap(const QString &element)
@@ -330,78 +415,78 @@ void PanelShadows::Private::setupData(Plasma::FrameSvg::EnabledBorders enabledBo
     }
     //shadow-top
     if (enabledBorders & Plasma::FrameSvg::TopBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_shadowPixmaps[0]));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_shadowPixmaps[0]));
     } else {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyHorizontalPix));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_emptyHorizontalPix));
     }
 
     //shadow-topright
     if (enabledBorders & Plasma::FrameSvg::TopBorder &&
         enabledBorders & Plasma::FrameSvg::RightBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_shadowPixmaps[1]));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_shadowPixmaps[1]));
     } else if (enabledBorders & Plasma::FrameSvg::TopBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerTopPix));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_emptyCornerTopPix));
     } else if (enabledBorders & Plasma::FrameSvg::RightBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerRightPix));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_emptyCornerRightPix));
     } else {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerPix));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_emptyCornerPix));
     }
 
     //shadow-right
     if (enabledBorders & Plasma::FrameSvg::RightBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_shadowPixmaps[2]));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_shadowPixmaps[2]));
     } else {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyVerticalPix));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_emptyVerticalPix));
     }
 
     //shadow-bottomright
     if (enabledBorders & Plasma::FrameSvg::BottomBorder &&
         enabledBorders & Plasma::FrameSvg::RightBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_shadowPixmaps[3]));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_shadowPixmaps[3]));
     } else if (enabledBorders & Plasma::FrameSvg::BottomBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerBottomPix));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_emptyCornerBottomPix));
     } else if (enabledBorders & Plasma::FrameSvg::RightBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerRightPix));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_emptyCornerRightPix));
     } else {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerPix));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_emptyCornerPix));
     }
 
     //shadow-bottom
     if (enabledBorders & Plasma::FrameSvg::BottomBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_shadowPixmaps[4]));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_shadowPixmaps[4]));
     } else {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyHorizontalPix));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_emptyHorizontalPix));
     }
 
     //shadow-bottomleft
     if (enabledBorders & Plasma::FrameSvg::BottomBorder &&
         enabledBorders & Plasma::FrameSvg::LeftBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_shadowPixmaps[5]));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_shadowPixmaps[5]));
     } else if (enabledBorders & Plasma::FrameSvg::BottomBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerBottomPix));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_emptyCornerBottomPix));
     } else if (enabledBorders & Plasma::FrameSvg::LeftBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerLeftPix));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_emptyCornerLeftPix));
     } else {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerPix));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_emptyCornerPix));
     }
 
     //shadow-left
     if (enabledBorders & Plasma::FrameSvg::LeftBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_shadowPixmaps[6]));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_shadowPixmaps[6]));
     } else {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyVerticalPix));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_emptyVerticalPix));
     }
 
     //shadow-topleft
     if (enabledBorders & Plasma::FrameSvg::TopBorder &&
         enabledBorders & Plasma::FrameSvg::LeftBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_shadowPixmaps[7]));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_shadowPixmaps[7]));
     } else if (enabledBorders & Plasma::FrameSvg::TopBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerTopPix));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_emptyCornerTopPix));
     } else if (enabledBorders & Plasma::FrameSvg::LeftBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerLeftPix));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_emptyCornerLeftPix));
     } else {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerPix));
+        data[enabledBorders] << reinterpret_cast<unsigned long>(x11Pixmap(m_emptyCornerPix));
     }
 #endif
 
@@ -462,38 +547,13 @@ void PanelShadows::Private::freeX11Pixmaps()
         return;
     }
 
-    auto *display = QX11Info::display();
-    if (!display) {
-        return;
-    }
-
-    foreach (const QPixmap &pixmap, m_shadowPixmaps) {
-        if (!pixmap.isNull()) {
-            XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(pixmap)));
+    if (!shadowTilesAtlas.isDestroyed()) {
+        for (const auto tile : m_x11Pixmaps) {
+            shadowTilesAtlas->release(tile);
         }
     }
 
-    if (!m_emptyCornerPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerPix)));
-    }
-    if (!m_emptyCornerBottomPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerBottomPix)));
-    }
-    if (!m_emptyCornerLeftPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerLeftPix)));
-    }
-    if (!m_emptyCornerRightPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerRightPix)));
-    }
-    if (!m_emptyCornerTopPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerTopPix)));
-    }
-    if (!m_emptyVerticalPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyVerticalPix)));
-    }
-    if (!m_emptyHorizontalPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyHorizontalPix)));
-    }
+    m_x11Pixmaps.clear();
 #endif
 }
 
@@ -1120,6 +1120,8 @@ void View::setLayout(Layout::GenericLayout *layout)
         }
 
         connectionsLayout << connect(m_positioner, &Latte::ViewPart::Positioner::edgeChanged, m_layout, &Layout::GenericLayout::viewEdgeChanged);
+        connectionsLayout << connect(this, &QWindow::screenChanged, m_layout, &Layout::GenericLayout::invalidateSortedLatteViews);
+        connectionsLayout << connect(this, &View::isPreferredForShortcutsChanged, m_layout, &Layout::GenericLayout::invalidateSortedLatteViews);
 
         //! Sometimes the activity isnt completely ready, by adding a delay
         //! we try to catch up
@@ -27,18 +27,24 @@
 
 // Qt
 #include <QDebug>
+#include <QFile>
 
 // KDE
 #include <KActivities/Controller>
+#include <KSycoca>
 
 namespace Latte {
 namespace WindowSystem {
 
 #define MAXPLASMAPANELTHICKNESS 96
 #define MAXSIDEPANELTHICKNESS 512
+#define MAXWINDOWSWAITINGTIME 600
+#define MAXCACHEDAPPIDENTITIES 256
 
 AbstractWindowInterface::AbstractWindowInterface(QObject *parent)
-    : QObject(parent)
+    : QObject(parent),
+      m_appIdentityUrls(MAXCACHEDAPPIDENTITIES),
+      m_appData(MAXCACHEDAPPIDENTITIES)
 {
     m_activities = new KActivities::Consumer(this);
     m_currentActivity = m_activities->currentActivity();
@@ -53,15 +59,21 @@ AbstractWindowInterface::AbstractWindowInterface(QObject *parent)
     m_windowWaitingTimer.setSingleShot(true);
 
     connect(&m_windowWaitingTimer, &QTimer::timeout, this, [&]() {
-        WindowId wid = m_windowChangedWaiting;
-        m_windowChangedWaiting = QVariant();
-        emit windowChanged(wid);
+        QList<WindowId> wids = m_windowsChangedWaiting;
+        m_windowsChangedWaiting.clear();
+        emit windowsChanged(wids);
     });
 
     connect(this, &AbstractWindowInterface::windowRemoved, this, &AbstractWindowInterface::windowRemovedSlot);
 
-    // connect(this, &AbstractWindowInterface::windowChanged, this, [&](WindowId wid) {
-    //     qDebug() << "WINDOW CHANGED ::: " << wid;
+    //! installed applications changed, identification results might be different now
+    connect(KSycoca::self(), static_cast<void (KSycoca::*)()>(&KSycoca::databaseChanged), this, [&]() {
+        m_appIdentityUrls.clear();
+        m_appData.clear();
+    });
+
+    // connect(this, &AbstractWindowInterface::windowsChanged, this, [&](const QList<WindowId> &wids) {
+    //     qDebug() << "WINDOWS CHANGED ::: " << wids;
     // });
 
     connect(m_activities.data(), &KActivities::Consumer::currentActivityChanged, this, [&](const QString &id) {
@@ -104,6 +116,17 @@ Tracker::Windows *AbstractWindowInterface::windowsTracker() const
     return m_windowsTracker;
 }
 
+QList<WindowInfoWrap> AbstractWindowInterface::requestInfos(const QList<WindowId> &wids)
+{
+    QList<WindowInfoWrap> infos;
+
+    for (const auto &wid : wids) {
+        infos << requestInfo(wid);
+    }
+
+    return infos;
+}
+
 bool AbstractWindowInterface::isIgnored(const WindowId &wid) const
 {
     return m_ignoredWindows.contains(wid);
@@ -205,7 +228,7 @@ void AbstractWindowInterface::registerIgnoredWindow(WindowId wid)
 {
     if (!wid.isNull() && !m_ignoredWindows.contains(wid)) {
         m_ignoredWindows.append(wid);
-        emit windowChanged(wid);
+        emit windowsChanged({wid});
     }
 }
 
@@ -221,7 +244,7 @@ void AbstractWindowInterface::registerPlasmaIgnoredWindow(WindowId wid)
 {
     if (!wid.isNull() && !m_plasmaIgnoredWindows.contains(wid)) {
         m_plasmaIgnoredWindows.append(wid);
-        emit windowChanged(wid);
+        emit windowsChanged({wid});
     }
 }
 
@@ -236,7 +259,7 @@ void AbstractWindowInterface::registerWhitelistedWindow(WindowId wid)
 {
     if (!wid.isNull() && !m_whitelistedWindows.contains(wid)) {
         m_whitelistedWindows.append(wid);
-        emit windowChanged(wid);
+        emit windowsChanged({wid});
     }
 }
 
@@ -249,6 +272,8 @@ void AbstractWindowInterface::unregisterWhitelistedWindow(WindowId wid)
 
 void AbstractWindowInterface::windowRemovedSlot(WindowId wid)
 {
+    releaseCmdLineHash(wid);
+
     if (m_plasmaIgnoredWindows.contains(wid)) {
         unregisterPlasmaIgnoredWindow(wid);
     }
@@ -262,6 +287,78 @@ void AbstractWindowInterface::windowRemovedSlot(WindowId wid)
     }
 }
 
+//! Application identification
+QString AbstractWindowInterface::appIdentityKey(const WindowId &wid, const QStringList &metadata, quint32 pid)
+{
+    bool hasMetadata = std::any_of(metadata.constBegin(), metadata.constEnd(), [](const QString &value) {
+        return !value.isEmpty();
+    });
+
+    //! windows without any metadata can not be told apart
+    if (!hasMetadata) {
+        return QString();
+    }
+
+    //! WM_CLASS is not unique for java, wine or electron wrapped applications,
+    //! so the process is part of the identity
+    QString key = metadata.join(QStringLiteral("::")) + QStringLiteral("::") + QString::number(pid);
+
+    if (pid > 0) {
+        key += QStringLiteral("::") + QString::number(cmdLineHash(wid, pid));
+    }
+
+    return key;
+}
+
+uint AbstractWindowInterface::cmdLineHash(const WindowId &wid, quint32 pid)
+{
+    if (!m_pidWindows[pid].contains(wid)) {
+        m_pidWindows[pid] << wid;
+    }
+
+    if (!m_cmdLineHashes.contains(pid)) {
+        //! pids can be reused and processes can exec, so the command line is part of the identity
+        QFile cmdLine(QStringLiteral("/proc/") + QString::number(pid) + QStringLiteral("/cmdline"));
+        m_cmdLineHashes[pid] = cmdLine.open(QIODevice::ReadOnly) ? qHash(cmdLine.readAll()) : 0;
+    }
+
+    return m_cmdLineHashes[pid];
+}
+
+void AbstractWindowInterface::releaseCmdLineHash(const WindowId &wid)
+{
+    for (auto it = m_pidWindows.begin(); it != m_pidWindows.end(); ++it) {
+        if (it.value().removeAll(wid) > 0) {
+            //! the pid may be reused from a different process afterwards
+            if (it.value().isEmpty()) {
+                m_cmdLineHashes.remove(it.key());
+                m_pidWindows.erase(it);
+            }
+
+            return;
+        }
+    }
+}
+
+AppData AbstractWindowInterface::cachedAppData(const QString &identityKey, std::function<QUrl()> resolveUrl)
+{
+    if (identityKey.isEmpty()) {
+        return appDataFromUrl(resolveUrl());
+    }
+
+    if (!m_appIdentityUrls.contains(identityKey)) {
+        m_appIdentityUrls.insert(identityKey, new QUrl(resolveUrl()));
+    }
+
+    const QUrl url = *m_appIdentityUrls.object(identityKey);
+
+    if (!m_appData.contains(url)) {
+        m_appData.insert(url, new AppData(appDataFromUrl(url)));
+    }
+
+    return *m_appData.object(url);
+}
+
 //! Activities switching
 void AbstractWindowInterface::switchToNextActivity()
 {
@@ -302,31 +399,24 @@ void AbstractWindowInterface::switchToPreviousActivity()
 //! Delay window changed trigerring
 void AbstractWindowInterface::considerWindowChanged(WindowId wid)
 {
-    //! Consider if the windowChanged signal should be sent DIRECTLY or WAIT
+    //! Consider when the windowsChanged signal should be sent, all windows
+    //! changing in the meantime are sent together
 
-    if (m_windowChangedWaiting == wid && m_windowWaitingTimer.isActive()) {
-        //! window should be sent later
-        m_windowWaitingTimer.start();
-        return;
+    if (!m_windowsChangedWaiting.contains(wid)) {
+        m_windowsChangedWaiting << wid;
     }
 
-    if (m_windowChangedWaiting != wid && !m_windowWaitingTimer.isActive()) {
-        //! window should be sent later
-        m_windowChangedWaiting = wid;
+    if (!m_windowWaitingTimer.isActive()) {
+        m_windowsWaitingTime.start();
         m_windowWaitingTimer.start();
+        return;
     }
 
-    if (m_windowChangedWaiting != wid && m_windowWaitingTimer.isActive()) {
-        m_windowWaitingTimer.stop();
-        //! sent previous waiting window
-        emit windowChanged(m_windowChangedWaiting);
-
-        //! retrigger waiting for the upcoming window
-        m_windowChangedWaiting = wid;
+    //! windows should be sent later unless they are already waiting for too long
+    if (m_windowsWaitingTime.elapsed() < MAXWINDOWSWAITINGTIME) {
         m_windowWaitingTimer.start();
     }
 }
-
 }
 }
 
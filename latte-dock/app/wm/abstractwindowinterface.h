@@ -29,13 +29,18 @@
 #include "tracker/windowstracker.h"
 
 // C++
+#include <algorithm>
+#include <functional>
 #include <unordered_map>
 #include <list>
 
 // Qt
+#include <QCache>
 #include <QObject>
 #include <QWindow>
 #include <QDialog>
+#include <QElapsedTimer>
+#include <QHash>
 #include <QMap>
 #include <QRect>
 #include <QPoint>
@@ -91,6 +96,8 @@ public:
     virtual WindowId activeWindow() = 0;
     virtual WindowInfoWrap requestInfo(WindowId wid) = 0;
     virtual WindowInfoWrap requestInfoActive() = 0;
+    //! information for many windows at once, window systems that can batch their requests should reimplement it
+    virtual QList<WindowInfoWrap> requestInfos(const QList<WindowId> &wids);
 
     virtual void skipTaskBar(const QDialog &dialog) = 0;
     virtual void slideWindow(QWindow &view, Slide location) = 0;
@@ -145,7 +152,8 @@ public:
 
 signals:
     void activeWindowChanged(WindowId wid);
-    void windowChanged(WindowId winfo);
+    //! windows that changed are batched together in order to be processed at once
+    void windowsChanged(const QList<WindowId> &wids);
     void windowAdded(WindowId wid);
     void windowRemoved(WindowId wid);
     void currentDesktopChanged();
@@ -168,17 +176,24 @@ protected:
 
     QPointer<KActivities::Consumer> m_activities;
 
-    //! Sending too fast plenty of signals for the same window
+    //! Sending too fast plenty of signals for the same windows
     //! has no reason and can create HIGH CPU usage. This Timer
-    //! can delay the batch sending of signals for the same window
-    WindowId m_windowChangedWaiting;
+    //! can delay the batch sending of signals for all changed windows
+    QList<WindowId> m_windowsChangedWaiting;
     QTimer m_windowWaitingTimer;
+    //! bursts of changes must not postpone forever the windows waiting
+    QElapsedTimer m_windowsWaitingTime;
 
     //! Plasma taskmanager rules ile
     KSharedConfig::Ptr rulesConfig;
 
     void considerWindowChanged(WindowId wid);
 
+    //! application identification queries the services database and the process
+    //! information, so its results are memoized based on the window metadata
+    AppData cachedAppData(const QString &identityKey, std::function<QUrl()> resolveUrl);
+    QString appIdentityKey(const WindowId &wid, const QStringList &metadata, quint32 pid);
+
     bool isIgnored(const WindowId &wid) const;
     bool isRegisteredPlasmaIgnoredWindow(const WindowId &wid) const;
     bool isWhitelistedWindow(const WindowId &wid) const;
@@ -191,6 +206,18 @@ private slots:
     void windowRemovedSlot(WindowId wid);
 
 private:
+    uint cmdLineHash(const WindowId &wid, quint32 pid);
+    void releaseCmdLineHash(const WindowId &wid);
+
+private:
+    //! application identity and its resolved url, empty urls are cached also
+    QCache<QString, QUrl> m_appIdentityUrls;
+    QCache<QUrl, AppData> m_appData;
+
+    //! command line hashes of the processes that own the tracked windows
+    QHash<quint32, uint> m_cmdLineHashes;
+    QHash<quint32, QList<WindowId>> m_pidWindows;
+
     Latte::Corona *m_corona;
     Tracker::Schemes *m_schemesTracker;
     Tracker::Windows *m_windowsTracker;
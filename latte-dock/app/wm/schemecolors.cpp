@@ -30,7 +30,6 @@
 
 // KDE
 #include <KConfigGroup>
-#include <KDirWatch>
 #include <KSharedConfig>
 
 namespace Latte {
@@ -45,15 +44,6 @@ SchemeColors::SchemeColors(QObject *parent, QString scheme, bool plasmaTheme) :
     if (QFileInfo(pSchemeFile).exists()) {
         setSchemeFile(pSchemeFile);
         m_schemeName = schemeName(pSchemeFile);
-
-        //! track scheme file for changes
-        KDirWatch::self()->addFile(m_schemeFile);
-
-        connect(KDirWatch::self(), &KDirWatch::dirty, this, [ & ](const QString & path) {
-            if (path == m_schemeFile) {
-                updateScheme();
-            }
-        });
     }
 
     updateScheme();
@@ -64,6 +54,11 @@ SchemeColors::~SchemeColors()
     ///
 }
 
+bool SchemeColors::basedOnPlasmaTheme() const
+{
+    return m_basedOnPlasmaTheme;
+}
+
 QColor SchemeColors::backgroundColor() const
 {
     return m_activeBackgroundColor;
@@ -214,6 +209,9 @@ void SchemeColors::updateScheme()
     }
 
     KSharedConfigPtr filePtr = KSharedConfig::openConfig(m_schemeFile);
+    //! the file may still be cached from a previous read
+    filePtr->reparseConfiguration();
+
     KConfigGroup wmGroup = KConfigGroup(filePtr, "WM");
     KConfigGroup selGroup = KConfigGroup(filePtr, "Colors:Selection");
     //KConfigGroup viewGroup = KConfigGroup(filePtr, "Colors:View");
@@ -28,6 +28,8 @@
 namespace Latte {
 namespace WindowSystem {
 
+class SchemesRegistry;
+
 class SchemeColors: public QObject
 {
     Q_OBJECT
@@ -50,9 +52,10 @@ class SchemeColors: public QObject
     Q_PROPERTY(QColor buttonFocusColor READ buttonFocusColor NOTIFY colorsChanged)
 
 public:
-    SchemeColors(QObject *parent, QString scheme, bool plasmaTheme = false);
     ~SchemeColors() override;
 
+    bool basedOnPlasmaTheme() const;
+
     QString schemeName() const;
 
     QString schemeFile() const;
@@ -76,11 +79,16 @@ public:
     static QString possibleSchemeFile(QString scheme);
     static QString schemeName(QString originalFile);
 
+    friend class SchemesRegistry;
+
 signals:
     void colorsChanged();
     void schemeFileChanged();
 
-private slots:
+private:
+    //! schemes are created and shared only through SchemesRegistry
+    SchemeColors(QObject *parent, QString scheme, bool plasmaTheme = false);
+
     void updateScheme();
 
 private:
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2020  Michail Vourlakos <mvourlakos@gmail.com>
+ *
+ * This file is part of Latte-Dock
+ *
+ * Latte-Dock is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Latte-Dock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "schemesregistry.h"
+
+// local
+#include "schemecolors.h"
+
+// Qt
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+
+// KDE
+#include <KDirWatch>
+
+namespace Latte {
+namespace WindowSystem {
+
+SchemesRegistry::SchemesRegistry(QObject *parent)
+    : QObject(parent)
+{
+    connect(KDirWatch::self(), &KDirWatch::dirty, this, &SchemesRegistry::onFileChanged);
+    connect(KDirWatch::self(), &KDirWatch::created, this, &SchemesRegistry::onFileChanged);
+}
+
+SchemesRegistry::~SchemesRegistry()
+{
+    m_references.clear();
+
+    for (auto &state : m_files) {
+        qDeleteAll(state.schemes);
+    }
+
+    m_files.clear();
+}
+
+SchemesRegistry *SchemesRegistry::self()
+{
+    static SchemesRegistry registry;
+    return &registry;
+}
+
+SchemeColors *SchemesRegistry::acquire(const QString &scheme, bool plasmaTheme)
+{
+    QString file = SchemeColors::possibleSchemeFile(scheme);
+
+    if (m_files.contains(file)) {
+        //! file may have been rewritten before the watcher was able to notify us
+        onFileChanged(file);
+
+        for (auto *colors : m_files[file].schemes) {
+            if (colors->basedOnPlasmaTheme() == plasmaTheme) {
+                m_references[colors].count++;
+                return colors;
+            }
+        }
+    } else {
+        FileState state;
+        updateFileState(file, state);
+        m_files[file] = state;
+
+        if (!file.isEmpty()) {
+            //! track scheme file for changes
+            KDirWatch::self()->addFile(file);
+        }
+    }
+
+    SchemeColors *colors = new SchemeColors(this, file, plasmaTheme);
+    m_files[file].schemes << colors;
+
+    Reference reference;
+    reference.file = file;
+    reference.count = 1;
+    m_references[colors] = reference;
+
+    return colors;
+}
+
+void SchemesRegistry::release(SchemeColors *scheme)
+{
+    if (!scheme || !m_references.contains(scheme)) {
+        return;
+    }
+
+    if (--m_references[scheme].count > 0) {
+        return;
+    }
+
+    QString file = m_references.take(scheme).file;
+
+    if (m_files.contains(file)) {
+        m_files[file].schemes.removeAll(scheme);
+
+        if (m_files[file].schemes.isEmpty()) {
+            m_files.remove(file);
+
+            if (!file.isEmpty()) {
+                KDirWatch::self()->removeFile(file);
+            }
+        }
+    }
+
+    scheme->deleteLater();
+}
+
+bool SchemesRegistry::updateFileState(const QString &file, FileState &state) const
+{
+    QFileInfo info(file);
+
+    if (file.isEmpty() || !info.exists()) {
+        bool changed = (state.size >= 0);
+        state.lastModified = QDateTime();
+        state.size = -1;
+        state.hash.clear();
+        return changed;
+    }
+
+    if (state.size == info.size() && state.lastModified == info.lastModified()) {
+        return false;
+    }
+
+    state.lastModified = info.lastModified();
+    state.size = info.size();
+
+    QFile schemeFile(file);
+
+    if (!schemeFile.open(QIODevice::ReadOnly)) {
+        return true;
+    }
+
+    QByteArray hash = QCryptographicHash::hash(schemeFile.readAll(), QCryptographicHash::Sha1);
+
+    if (hash == state.hash) {
+        //! file was just touched
+        return false;
+    }
+
+    state.hash = hash;
+    return true;
+}
+
+void SchemesRegistry::onFileChanged(const QString &file)
+{
+    auto it = m_files.find(file);
+
+    if (it == m_files.end() || !updateFileState(file, it.value())) {
+        return;
+    }
+
+    qDebug() << "color scheme file changed :: " << file;
+
+    //! copy because schemes may be released from colorsChanged receivers
+    const QList<SchemeColors *> schemes = it.value().schemes;
+
+    for (auto *colors : schemes) {
+        colors->updateScheme();
+    }
+}
+
+}
+}
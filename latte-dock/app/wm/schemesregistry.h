@@ -0,0 +1,87 @@
+/*
+ * Copyright 2020  Michail Vourlakos <mvourlakos@gmail.com>
+ *
+ * This file is part of Latte-Dock
+ *
+ * Latte-Dock is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Latte-Dock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SCHEMESREGISTRY_H
+#define SCHEMESREGISTRY_H
+
+// Qt
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QObject>
+
+namespace Latte {
+namespace WindowSystem {
+class SchemeColors;
+}
+}
+
+namespace Latte {
+namespace WindowSystem {
+
+//! Process-wide registry of loaded color schemes. Schemes are shared and reference counted
+//! based on their file, so every file is parsed once no matter how many windows, views
+//! or themes are using it. All scheme files are tracked through a single KDirWatch
+//! connection and a scheme is reloaded only when its file contents really changed.
+class SchemesRegistry final: public QObject
+{
+    Q_OBJECT
+
+public:
+    static SchemesRegistry *self();
+    ~SchemesRegistry() override;
+
+    //! returns a shared scheme for the provided scheme name or file, each call must
+    //! be paired with a release(...) call
+    SchemeColors *acquire(const QString &scheme, bool plasmaTheme = false);
+    void release(SchemeColors *scheme);
+
+private slots:
+    void onFileChanged(const QString &file);
+
+private:
+    SchemesRegistry(QObject *parent = nullptr);
+
+    struct Reference {
+        QString file;
+        int count{0};
+    };
+
+    struct FileState {
+        QDateTime lastModified;
+        qint64 size{-1};
+        QByteArray hash;
+        QList<SchemeColors *> schemes;
+    };
+
+    //! updates file state and returns true when the file contents changed
+    bool updateFileState(const QString &file, FileState &state) const;
+
+private:
+    //! scheme file and its loaded schemes
+    QHash<QString, FileState> m_files;
+    QHash<SchemeColors *, Reference> m_references;
+};
+
+}
+}
+
+#endif
@@ -55,7 +55,7 @@ LastActiveWindow::LastActiveWindow(TrackedGeneralInfo *trackedInfo)
     });
 
     connect(m_windowsTracker, &Windows::applicationDataChanged, this, &LastActiveWindow::applicationDataChanged);
-    connect(m_windowsTracker, &Windows::windowChanged, this, &LastActiveWindow::windowChanged);
+    connect(m_windowsTracker, &Windows::windowsChanged, this, &LastActiveWindow::windowsChanged);
     connect(m_windowsTracker, &Windows::windowRemoved, this, &LastActiveWindow::windowRemoved);
 }
 
@@ -501,6 +501,19 @@ void LastActiveWindow::applicationDataChanged(const WindowId &wid)
 }
 
 
+void LastActiveWindow::windowsChanged(const QList<WindowId> &wids)
+{
+    if (!m_trackedInfo->enabled()) {
+        return;
+    }
+
+    for (const auto &wid : wids) {
+        if (m_history.contains(wid)) {
+            windowChanged(wid);
+        }
+    }
+}
+
 void LastActiveWindow::windowChanged(const WindowId &wid)
 {
     if (!m_trackedInfo->enabled()) {
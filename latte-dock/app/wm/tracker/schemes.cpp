@@ -21,6 +21,7 @@
 
 // local
 #include "../abstractwindowinterface.h"
+#include "../schemesregistry.h"
 #include "../../lattecorona.h"
 
 // Qt
@@ -44,9 +45,13 @@ Schemes::Schemes(AbstractWindowInterface *parent)
 Schemes::~Schemes()
 {
     m_windowScheme.clear();
-    //! it is just a reference to a real scheme file
-    m_schemes.take("kdeglobals");
-    qDeleteAll(m_schemes);
+    m_schemeIds.clear();
+    m_defaultScheme = nullptr;
+
+    for (auto *scheme : m_schemes) {
+        SchemesRegistry::self()->release(scheme);
+    }
+
     m_schemes.clear();
 }
 
@@ -89,29 +94,25 @@ void Schemes::updateDefaultScheme()
 
     qDebug() << " Windows default color scheme :: " << defaultSchemePath;
 
-    SchemeColors *dScheme;
+    m_defaultScheme = schemeForFile(defaultSchemePath);
 
-    if (!m_schemes.contains(defaultSchemePath)) {
-        dScheme = new SchemeColors(this, defaultSchemePath);
-        m_schemes[defaultSchemePath] = dScheme;
-    } else {
-        dScheme = m_schemes[defaultSchemePath];
-    }
+    //! scheme ids may resolve to different files after a color schemes change
+    m_schemeIds.clear();
+}
 
-    if (!m_schemes.contains("kdeglobals") || m_schemes["kdeglobals"]->schemeFile() != defaultSchemePath) {
-        m_schemes["kdeglobals"] = dScheme;
+SchemeColors *Schemes::schemeForFile(const QString &file)
+{
+    if (!m_schemes.contains(file)) {
+        //! when this scheme file has not been loaded yet
+        m_schemes[file] = SchemesRegistry::self()->acquire(file);
     }
+
+    return m_schemes[file];
 }
 
 SchemeColors *Schemes::schemeForWindow(WindowId wid)
 {
-    if (!m_windowScheme.contains(wid)) {
-        return m_schemes["kdeglobals"];
-    } else {
-        return m_schemes[m_windowScheme[wid]];
-    }
-
-    return nullptr;
+    return m_windowScheme.value(wid, m_defaultScheme);
 }
 
 void Schemes::setColorSchemeForWindow(WindowId wid, QString scheme)
@@ -125,14 +126,17 @@ void Schemes::setColorSchemeForWindow(WindowId wid, QString scheme)
         //! a window that previously had an explicit set scheme now is set back to default scheme
         m_windowScheme.remove(wid);
     } else {
-        QString schemeFile = SchemeColors::possibleSchemeFile(scheme);
+        if (!m_schemeIds.contains(scheme)) {
+            m_schemeIds[scheme] = schemeForFile(SchemeColors::possibleSchemeFile(scheme));
+        }
+
+        SchemeColors *colors = m_schemeIds[scheme];
 
-        if (!m_schemes.contains(schemeFile)) {
-            //! when this scheme file has not been loaded yet
-            m_schemes[schemeFile] = new SchemeColors(this, schemeFile);
+        if (m_windowScheme.value(wid, nullptr) == colors) {
+            return;
         }
 
-        m_windowScheme[wid] = schemeFile;
+        m_windowScheme[wid] = colors;
     }
 
     emit colorSchemeChanged(wid);
@@ -24,6 +24,8 @@
 #include "../windowinfowrap.h"
 
 // Qt
+#include <QHash>
+#include <QMap>
 #include <QObject>
 
 
@@ -57,14 +59,22 @@ private slots:
 private:
     void init();
 
+    SchemeColors *schemeForFile(const QString &file);
+
 private:
      AbstractWindowInterface *m_wm;
 
+     SchemeColors *m_defaultScheme{nullptr};
+
      //! scheme file and its loaded colors
-     QMap<QString, Latte::WindowSystem::SchemeColors *> m_schemes;
+     QHash<QString, Latte::WindowSystem::SchemeColors *> m_schemes;
+
+     //! interned scheme ids, as provided by the windows, and their resolved colors
+     QHash<QString, Latte::WindowSystem::SchemeColors *> m_schemeIds;
 
-     //! window id and its corresponding scheme file
-     QMap<WindowId, QString> m_windowScheme;
+     //! window id and its explicitly set scheme colors, windows that are not
+     //! present are using the default scheme
+     QMap<WindowId, Latte::WindowSystem::SchemeColors *> m_windowScheme;
 };
 
 }
@@ -0,0 +1,242 @@
+/*
+*  Copyright 2020  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "spatialindex.h"
+
+namespace Latte {
+namespace WindowSystem {
+namespace Tracker {
+
+SpatialIndex::SpatialIndex()
+{
+}
+
+bool SpatialIndex::isFaulty(const WindowInfoWrap &winfo)
+{
+    //! the notification window is not sending a remove signal and creates windows of geometry (0x0 0,0)
+    return (winfo.wid()<=0 || winfo.geometry() == QRect(0, 0, 0, 0));
+}
+
+//! Bands
+bool SpatialIndex::hasBand(Latte::View *view, const QRect &screenGeometry, const QRect &band) const
+{
+    if (!m_bands.contains(view)) {
+        return false;
+    }
+
+    const Band &current = m_bands[view];
+    return (current.screenGeometry == screenGeometry && current.geometry == band);
+}
+
+void SpatialIndex::setBand(Latte::View *view, const QRect &screenGeometry, const QRect &band)
+{
+    if (hasBand(view, screenGeometry, band)) {
+        return;
+    }
+
+    removeBand(view);
+
+    Band newBand;
+    newBand.screenGeometry = screenGeometry;
+    newBand.geometry = band;
+
+    //! band geometry changes are rare compared to window changes, so a full rescan is fine here
+    for (auto i = m_windows.constBegin(); i != m_windows.constEnd(); ++i) {
+        if (i.value().geometry.intersects(band)) {
+            newBand.windows[i.key()] = i.value().geometry;
+        }
+    }
+
+    m_bands[view] = newBand;
+    addScreenBand(screenGeometry, view);
+}
+
+void SpatialIndex::removeBand(Latte::View *view)
+{
+    if (!m_bands.contains(view)) {
+        return;
+    }
+
+    removeScreenBand(m_bands[view].screenGeometry, view);
+    m_bands.remove(view);
+}
+
+void SpatialIndex::addScreenBand(const QRect &screenGeometry, Latte::View *view)
+{
+    for (auto &screen : m_screens) {
+        if (screen.first == screenGeometry) {
+            if (!screen.second.contains(view)) {
+                screen.second << view;
+            }
+            return;
+        }
+    }
+
+    m_screens << qMakePair(screenGeometry, QList<Latte::View *>({view}));
+}
+
+void SpatialIndex::removeScreenBand(const QRect &screenGeometry, Latte::View *view)
+{
+    for (int i=0; i<m_screens.count(); ++i) {
+        if (m_screens[i].first == screenGeometry) {
+            m_screens[i].second.removeAll(view);
+
+            if (m_screens[i].second.isEmpty()) {
+                m_screens.removeAt(i);
+            }
+            return;
+        }
+    }
+}
+
+//! Windows
+void SpatialIndex::insert(const WindowId &wid, const WindowInfoWrap &winfo)
+{
+    Entry entry;
+    entry.geometry = winfo.geometry();
+    entry.isActive = winfo.isActive();
+    entry.isMaximized = winfo.isMaximized();
+    entry.isFaulty = isFaulty(winfo);
+
+    if (m_windows.contains(wid)) {
+        unindexWindow(wid, m_windows[wid]);
+    }
+
+    m_windows[wid] = entry;
+    indexWindow(wid, entry);
+}
+
+void SpatialIndex::remove(const WindowId &wid)
+{
+    if (!m_windows.contains(wid)) {
+        return;
+    }
+
+    unindexWindow(wid, m_windows[wid]);
+    m_windows.remove(wid);
+}
+
+void SpatialIndex::clear()
+{
+    for (auto &band : m_bands) {
+        band.windows.clear();
+    }
+
+    m_windows.clear();
+    m_activeWindows.clear();
+    m_maximizedWindows.clear();
+    m_faultyWindows = 0;
+}
+
+void SpatialIndex::indexWindow(const WindowId &wid, const Entry &entry)
+{
+    if (entry.isFaulty) {
+        m_faultyWindows++;
+    }
+
+    if (entry.isActive) {
+        m_activeWindows[wid] = entry.geometry;
+    }
+
+    if (entry.isMaximized) {
+        m_maximizedWindows[wid] = entry.geometry;
+    }
+
+    for (const auto &screen : m_screens) {
+        //! bands can exceed their screen by one pixel
+        if (!entry.geometry.intersects(screen.first.adjusted(-1, -1, 1, 1))) {
+            continue;
+        }
+
+        for (const auto view : screen.second) {
+            Band &band = m_bands[view];
+
+            if (entry.geometry.intersects(band.geometry)) {
+                band.windows[wid] = entry.geometry;
+            }
+        }
+    }
+}
+
+void SpatialIndex::unindexWindow(const WindowId &wid, const Entry &entry)
+{
+    if (entry.isFaulty) {
+        m_faultyWindows--;
+    }
+
+    m_activeWindows.remove(wid);
+    m_maximizedWindows.remove(wid);
+
+    for (const auto &screen : m_screens) {
+        if (!entry.geometry.intersects(screen.first.adjusted(-1, -1, 1, 1))) {
+            continue;
+        }
+
+        for (const auto view : screen.second) {
+            m_bands[view].windows.remove(wid);
+        }
+    }
+}
+
+bool SpatialIndex::hasFaultyWindows() const
+{
+    return (m_faultyWindows > 0);
+}
+
+QList<WindowId> SpatialIndex::activeWindows() const
+{
+    return m_activeWindows.keys();
+}
+
+QList<WindowId> SpatialIndex::maximizedWindows() const
+{
+    return m_maximizedWindows.keys();
+}
+
+QList<WindowId> SpatialIndex::windowsInBand(Latte::View *view) const
+{
+    if (!m_bands.contains(view)) {
+        return QList<WindowId>();
+    }
+
+    return m_bands[view].windows.keys();
+}
+
+QList<WindowId> SpatialIndex::candidateWindows(Latte::View *view) const
+{
+    QMap<WindowId, QRect> candidates = m_activeWindows;
+
+    for (auto i = m_maximizedWindows.constBegin(); i != m_maximizedWindows.constEnd(); ++i) {
+        candidates[i.key()] = i.value();
+    }
+
+    if (view && m_bands.contains(view)) {
+        const Band &band = m_bands[view];
+
+        for (auto i = band.windows.constBegin(); i != band.windows.constEnd(); ++i) {
+            candidates[i.key()] = i.value();
+        }
+    }
+
+    return candidates.keys();
+}
+
+}
+}
+}
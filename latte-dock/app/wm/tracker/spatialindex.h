@@ -0,0 +1,112 @@
+/*
+*  Copyright 2020  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef WINDOWSYSTEMTRACKERSPATIALINDEX_H
+#define WINDOWSYSTEMTRACKERSPATIALINDEX_H
+
+// local
+#include "../windowinfowrap.h"
+
+// Qt
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QPair>
+#include <QRect>
+
+namespace Latte {
+class View;
+}
+
+namespace Latte {
+namespace WindowSystem {
+namespace Tracker {
+
+//! Spatial index for the tracked windows. Every tracked view registers an edge band,
+//! that is its absolute geometry grown by one pixel in order to catch also windows that
+//! touch its edge. Bands are bucketed per screen and each window is assigned to the bands
+//! it intersects at the time it changes. This way a view can query only the windows near
+//! its edge instead of walking all windows for every window change.
+class SpatialIndex
+{
+public:
+    SpatialIndex();
+
+    //! Bands
+    bool hasBand(Latte::View *view, const QRect &screenGeometry, const QRect &band) const;
+    void setBand(Latte::View *view, const QRect &screenGeometry, const QRect &band);
+    void removeBand(Latte::View *view);
+
+    //! Windows
+    void insert(const WindowId &wid, const WindowInfoWrap &winfo);
+    void remove(const WindowId &wid);
+    void clear();
+
+    bool hasFaultyWindows() const;
+
+    //! all returned lists are sorted by window id in order to preserve the
+    //! windows iteration order of Tracker::Windows
+    QList<WindowId> activeWindows() const;
+    QList<WindowId> maximizedWindows() const;
+    QList<WindowId> windowsInBand(Latte::View *view) const;
+
+    //! active and maximized windows, plus the ones in view edge band when a view is provided
+    QList<WindowId> candidateWindows(Latte::View *view = nullptr) const;
+
+    static bool isFaulty(const WindowInfoWrap &winfo);
+
+private:
+    struct Band {
+        QRect screenGeometry;
+        QRect geometry;
+        QMap<WindowId, QRect> windows;
+    };
+
+    struct Entry {
+        QRect geometry;
+        bool isActive{false};
+        bool isMaximized{false};
+        bool isFaulty{false};
+    };
+
+    void addScreenBand(const QRect &screenGeometry, Latte::View *view);
+    void removeScreenBand(const QRect &screenGeometry, Latte::View *view);
+
+    void indexWindow(const WindowId &wid, const Entry &entry);
+    void unindexWindow(const WindowId &wid, const Entry &entry);
+
+private:
+    int m_faultyWindows{0};
+
+    QHash<Latte::View *, Band> m_bands;
+
+    //! screen geometry -> views in that screen, screens are very few so a
+    //! plain list is faster than any hashing
+    QList<QPair<QRect, QList<Latte::View *>>> m_screens;
+
+    QMap<WindowId, Entry> m_windows;
+    QMap<WindowId, QRect> m_activeWindows;
+    QMap<WindowId, QRect> m_maximizedWindows;
+};
+
+}
+}
+}
+
+#endif
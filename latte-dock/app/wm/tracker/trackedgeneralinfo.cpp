@@ -161,6 +161,49 @@ bool TrackedGeneralInfo::isTracking(const WindowInfoWrap &winfo) const
             && winfo.isOnActivity(m_wm->currentActivity()));
 }
 
+const WindowsSet &TrackedGeneralInfo::activeWindows() const
+{
+    return m_activeWindows;
+}
+
+const WindowsSet &TrackedGeneralInfo::maximizedWindows() const
+{
+    return m_maximizedWindows;
+}
+
+void TrackedGeneralInfo::setWindowActive(const WindowId &wid, bool active)
+{
+    m_activeWindows.update(wid, active, true);
+}
+
+void TrackedGeneralInfo::setWindowMaximized(const WindowId &wid, bool maximized, bool isActive)
+{
+    m_maximizedWindows.update(wid, maximized, isActive);
+}
+
+bool TrackedGeneralInfo::windowsSynced() const
+{
+    return m_windowsSynced;
+}
+
+void TrackedGeneralInfo::setWindowsSynced(bool synced)
+{
+    m_windowsSynced = synced;
+}
+
+void TrackedGeneralInfo::removeWindow(const WindowId &wid)
+{
+    m_activeWindows.remove(wid);
+    m_maximizedWindows.remove(wid);
+}
+
+void TrackedGeneralInfo::clearWindows()
+{
+    m_activeWindows.clear();
+    m_maximizedWindows.clear();
+    m_windowsSynced = false;
+}
+
 }
 }
 }
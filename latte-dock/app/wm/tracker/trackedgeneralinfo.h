@@ -22,6 +22,7 @@
 
 // local
 #include "lastactivewindow.h"
+#include "windowsset.h"
 #include "../windowinfowrap.h"
 
 // Qt
@@ -75,6 +76,21 @@ public:
 
     virtual bool isTracking(const WindowInfoWrap &winfo) const;
 
+    //! windows that are currently affecting the tracking hints
+    const WindowsSet &activeWindows() const;
+    const WindowsSet &maximizedWindows() const;
+
+    void setWindowActive(const WindowId &wid, bool active);
+    void setWindowMaximized(const WindowId &wid, bool maximized, bool isActive);
+
+    //! windows sets are updated per window change only when they are synced,
+    //! otherwise they must be rebuilt from all windows
+    bool windowsSynced() const;
+    void setWindowsSynced(bool synced);
+
+    virtual void removeWindow(const WindowId &wid);
+    virtual void clearWindows();
+
 signals:
     void lastActiveWindowChanged();
 
@@ -95,6 +111,10 @@ private:
     bool m_existsWindowMaximized;
 
     bool m_isTrackingCurrentActivity{true};
+    bool m_windowsSynced{false};
+
+    WindowsSet m_activeWindows;
+    WindowsSet m_maximizedWindows;
 
     SchemeColors *m_activeWindowScheme{nullptr};
 };
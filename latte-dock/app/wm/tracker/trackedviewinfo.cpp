@@ -155,6 +155,42 @@ bool TrackedViewInfo::isTracking(const WindowInfoWrap &winfo) const
             && m_availableScreenGeometry.contains(winfo.geometry().center());
 }
 
+const WindowsSet &TrackedViewInfo::touchingWindows() const
+{
+    return m_touchingWindows;
+}
+
+const WindowsSet &TrackedViewInfo::touchingEdgeWindows() const
+{
+    return m_touchingEdgeWindows;
+}
+
+void TrackedViewInfo::setWindowTouching(const WindowId &wid, bool touching, bool isActive)
+{
+    m_touchingWindows.update(wid, touching, isActive);
+}
+
+void TrackedViewInfo::setWindowTouchingEdge(const WindowId &wid, bool touching, bool isActive)
+{
+    m_touchingEdgeWindows.update(wid, touching, isActive);
+}
+
+void TrackedViewInfo::removeWindow(const WindowId &wid)
+{
+    TrackedGeneralInfo::removeWindow(wid);
+
+    m_touchingWindows.remove(wid);
+    m_touchingEdgeWindows.remove(wid);
+}
+
+void TrackedViewInfo::clearWindows()
+{
+    TrackedGeneralInfo::clearWindows();
+
+    m_touchingWindows.clear();
+    m_touchingEdgeWindows.clear();
+}
+
 }
 }
 }
@@ -75,6 +75,15 @@ public:
 
     bool isTracking(const WindowInfoWrap &winfo) const override;
 
+    const WindowsSet &touchingWindows() const;
+    const WindowsSet &touchingEdgeWindows() const;
+
+    void setWindowTouching(const WindowId &wid, bool touching, bool isActive);
+    void setWindowTouchingEdge(const WindowId &wid, bool touching, bool isActive);
+
+    void removeWindow(const WindowId &wid) override;
+    void clearWindows() override;
+
 private:
     bool m_activeWindowTouching{false};
     bool m_existsWindowTouching{false};
@@ -86,6 +95,9 @@ private:
 
     SchemeColors *m_touchingWindowScheme{nullptr};
 
+    WindowsSet m_touchingWindows;
+    WindowsSet m_touchingEdgeWindows;
+
     Latte::View *m_view{nullptr};
 };
 
@@ -0,0 +1,141 @@
+/*
+*  Copyright 2020  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "windowsset.h"
+
+namespace Latte {
+namespace WindowSystem {
+namespace Tracker {
+
+WindowsSet::WindowsSet()
+{
+}
+
+bool WindowsSet::isEmpty() const
+{
+    return m_windows.isEmpty();
+}
+
+bool WindowsSet::contains(const WindowId &wid) const
+{
+    return m_windows.contains(wid);
+}
+
+bool WindowsSet::hasActive() const
+{
+    return (m_activeCount > 0);
+}
+
+bool WindowsSet::hasInactive() const
+{
+    return (m_windows.count() > m_activeCount);
+}
+
+WindowId WindowsSet::firstWindow() const
+{
+    return m_windows.isEmpty() ? WindowId() : m_windows.firstKey();
+}
+
+WindowId WindowsSet::lastWindow() const
+{
+    return m_windows.isEmpty() ? WindowId() : m_windows.lastKey();
+}
+
+WindowId WindowsSet::lastActiveWindow() const
+{
+    if (!hasActive()) {
+        return WindowId();
+    }
+
+    auto i = m_windows.constEnd();
+
+    while (i != m_windows.constBegin()) {
+        --i;
+
+        if (i.value()) {
+            return i.key();
+        }
+    }
+
+    return WindowId();
+}
+
+WindowId WindowsSet::lastInactiveWindow() const
+{
+    if (!hasInactive()) {
+        return WindowId();
+    }
+
+    auto i = m_windows.constEnd();
+
+    while (i != m_windows.constBegin()) {
+        --i;
+
+        if (!i.value()) {
+            return i.key();
+        }
+    }
+
+    return WindowId();
+}
+
+QList<WindowId> WindowsSet::windows() const
+{
+    return m_windows.keys();
+}
+
+void WindowsSet::update(const WindowId &wid, bool contained, bool isActive)
+{
+    if (!contained) {
+        remove(wid);
+        return;
+    }
+
+    auto i = m_windows.find(wid);
+
+    if (i == m_windows.end()) {
+        m_windows.insert(wid, isActive);
+        m_activeCount += isActive ? 1 : 0;
+    } else if (i.value() != isActive) {
+        i.value() = isActive;
+        m_activeCount += isActive ? 1 : -1;
+    }
+}
+
+void WindowsSet::remove(const WindowId &wid)
+{
+    auto i = m_windows.find(wid);
+
+    if (i == m_windows.end()) {
+        return;
+    }
+
+    m_activeCount -= i.value() ? 1 : 0;
+    m_windows.erase(i);
+}
+
+void WindowsSet::clear()
+{
+    m_windows.clear();
+    m_activeCount = 0;
+}
+
+}
+}
+}
@@ -0,0 +1,70 @@
+/*
+*  Copyright 2020  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef WINDOWSYSTEMTRACKERWINDOWSSET_H
+#define WINDOWSYSTEMTRACKERWINDOWSSET_H
+
+// local
+#include "../windowinfowrap.h"
+
+// Qt
+#include <QList>
+#include <QMap>
+
+namespace Latte {
+namespace WindowSystem {
+namespace Tracker {
+
+//! Windows that are affecting a tracking hint, e.g. the windows touching a view.
+//! Windows are ordered the same way Tracker::Windows is ordering them and their
+//! activeness is also counted, so the relevant hints can be answered immediately
+//! and updated per window change instead of rescanning all windows
+class WindowsSet
+{
+public:
+    WindowsSet();
+
+    bool isEmpty() const;
+    bool contains(const WindowId &wid) const;
+
+    bool hasActive() const;
+    bool hasInactive() const;
+
+    WindowId firstWindow() const;
+    WindowId lastWindow() const;
+    WindowId lastActiveWindow() const;
+    WindowId lastInactiveWindow() const;
+
+    QList<WindowId> windows() const;
+
+    void update(const WindowId &wid, bool contained, bool isActive);
+    void remove(const WindowId &wid);
+    void clear();
+
+private:
+    int m_activeCount{0};
+
+    QMap<WindowId, bool> m_windows;
+};
+
+}
+}
+}
+
+#endif
@@ -78,44 +78,47 @@ void Windows::init()
 {
     connect(m_wm->corona(), &Plasma::Corona::availableScreenRectChanged, this, &Windows::updateAvailableScreenGeometries);
 
-    connect(m_wm, &AbstractWindowInterface::windowChanged, this, [&](WindowId wid) {
-        m_windows[wid] = m_wm->requestInfo(wid);
-        updateAllHints();
+    connect(m_wm, &AbstractWindowInterface::windowsChanged, this, [&](const QList<WindowId> &wids) {
+        updateWindows(wids);
+        updateWindowHints(wids);
 
-        emit windowChanged(wid);
+        emit windowsChanged(wids);
     });
 
     connect(m_wm, &AbstractWindowInterface::windowRemoved, this, [&](WindowId wid) {
-        m_windows.remove(wid);
+        removeWindow(wid);
 
         //! application data
         m_initializedApplicationData.removeAll(wid);
         m_delayedApplicationData.removeAll(wid);
 
-        updateAllHints();
+        updateWindowHints({wid});
 
         emit windowRemoved(wid);
     });
 
     connect(m_wm, &AbstractWindowInterface::windowAdded, this, [&](WindowId wid) {
         if (!m_windows.contains(wid)) {
-            m_windows.insert(wid, m_wm->requestInfo(wid));
+            updateWindow(wid);
         }
-        updateAllHints();
+        updateWindowHints({wid});
     });
 
     connect(m_wm, &AbstractWindowInterface::activeWindowChanged, this, [&](WindowId wid) {
         //! for some reason this is needed in order to update properly activeness values
         //! when the active window changes the previous active windows should be also updated
+        QList<WindowId> changedWindows;
+
         for (const auto view : m_views.keys()) {
             WindowId lastWinId = m_views[view]->lastActiveWindow()->winId();
-            if ((lastWinId) != wid && m_windows.contains(lastWinId)) {
-                m_windows[lastWinId] = m_wm->requestInfo(lastWinId);
+            if ((lastWinId) != wid && m_windows.contains(lastWinId) && !changedWindows.contains(lastWinId)) {
+                changedWindows << lastWinId;
             }
         }
 
-        m_windows[wid] = m_wm->requestInfo(wid);
-        updateAllHints();
+        changedWindows << wid;
+        updateWindows(changedWindows);
+        updateWindowHints(changedWindows);
 
         emit activeWindowChanged(wid);
     });
@@ -204,6 +207,7 @@ void Windows::removeView(Latte::View *view)
 
     m_views[view]->deleteLater();
     m_views.remove(view);
+    m_index.removeBand(view);
 
     updateRelevantLayouts();
 }
@@ -298,6 +302,7 @@ void Windows::setEnabled(Latte::View *view, const bool enabled)
     if (enabled) {
         updateHints(view);
     } else {
+        m_index.removeBand(view);
         initViewHints(view);
     }
 
@@ -775,15 +780,46 @@ bool Windows::isTouchingViewEdge(Latte::View *view, const WindowInfoWrap &winfo)
     return false;
 }
 
+void Windows::updateWindow(const WindowId &wid)
+{
+    m_windows[wid] = m_wm->requestInfo(wid);
+    m_index.insert(wid, m_windows[wid]);
+}
+
+void Windows::updateWindows(const QList<WindowId> &wids)
+{
+    //! window systems can batch their requests for many windows
+    QList<WindowInfoWrap> infos = m_wm->requestInfos(wids);
+
+    for (int i=0; i<wids.count() && i<infos.count(); ++i) {
+        m_windows[wids[i]] = infos[i];
+        m_index.insert(wids[i], infos[i]);
+    }
+}
+
+void Windows::removeWindow(const WindowId &wid)
+{
+    m_windows.remove(wid);
+    m_index.remove(wid);
+
+    for (const auto viewInfo : m_views) {
+        viewInfo->removeWindow(wid);
+    }
+
+    for (const auto layoutInfo : m_layouts) {
+        layoutInfo->removeWindow(wid);
+    }
+}
+
 void Windows::cleanupFaultyWindows()
 {
     for (const auto &key : m_windows.keys()) {
         auto winfo = m_windows[key];
 
         //! garbage windows removing
-        if (winfo.wid()<=0 || winfo.geometry() == QRect(0, 0, 0, 0)) {
+        if (SpatialIndex::isFaulty(winfo)) {
             //qDebug() << "Faulty Geometry ::: " << winfo.wid();
-            m_windows.remove(key);
+            removeWindow(key);
         }
     }
 }
@@ -855,135 +891,184 @@ void Windows::updateExtraViewHints()
     }
 }
 
-void Windows::updateHints(Latte::View *view)
+void Windows::updateWindowHints(const QList<WindowId> &wids)
 {
-    if (!m_views.contains(view) || !m_views[view]->enabled() || !m_views[view]->isTrackingCurrentActivity()) {
-        return;
+    //! the notification window is not sending a remove signal and creates windows of geometry (0x0 0,0),
+    //! maybe a garbage collector here is a good idea!!!
+    if (m_index.hasFaultyWindows()) {
+        cleanupFaultyWindows();
     }
 
-    bool foundActive{false};
-    bool foundActiveInCurScreen{false};
-    bool foundActiveTouchInCurScreen{false};
-    bool foundActiveEdgeTouchInCurScreen{false};
-    bool foundTouchInCurScreen{false};
-    bool foundTouchEdgeInCurScreen{false};
-    bool foundMaximizedInCurScreen{false};
+    for (const auto view : m_views.keys()) {
+        updateWindowHints(view, wids);
+    }
 
-    bool foundActiveGroupTouchInCurScreen{false};
+    for (const auto layout : m_layouts.keys()) {
+        updateWindowHints(layout, wids);
+    }
 
-    //! the notification window is not sending a remove signal and creates windows of geometry (0x0 0,0),
-    //! maybe a garbage collector here is a good idea!!!
-    bool existsFaultyWindow{false};
+    if (!m_extraViewHintsTimer.isActive()) {
+        m_extraViewHintsTimer.start();
+    }
+}
 
-    WindowId maxWinId;
-    WindowId activeWinId;
-    WindowId touchWinId;
-    WindowId touchEdgeWinId;
-    WindowId activeTouchWinId;
-    WindowId activeTouchEdgeWinId;
+bool Windows::updateEdgeBand(Latte::View *view)
+{
+    //! only windows found in view edge band can touch the view
+    QRect band = view->absoluteGeometry().adjusted(-1, -1, 1, 1);
 
-    //qDebug() << " -- TRACKING REPORT (SCREEN)--";
+    if (m_index.hasBand(view, view->screenGeometry(), band)) {
+        return false;
+    }
 
-    //! First Pass
-    for (const auto &winfo : m_windows) {
-        if (!existsFaultyWindow && (winfo.wid()<=0 || winfo.geometry() == QRect(0, 0, 0, 0))) {
-            existsFaultyWindow = true;
-        }
+    m_index.setBand(view, view->screenGeometry(), band);
+    return true;
+}
 
-        if ( !m_wm->inCurrentDesktopActivity(winfo)
-             || m_wm->hasBlockedTracking(winfo.wid())
-             || winfo.isMinimized()) {
-            continue;
-        }
+void Windows::trackWindow(Latte::View *view, const WindowId &wid)
+{
+    TrackedViewInfo *viewInfo = m_views[view];
+    auto winfoIt = m_windows.constFind(wid);
 
-        //qDebug() << " _ _ _ ";
-        //qDebug() << "TRACKING | WINDOW INFO :: " << winfo.wid() << " _ " << winfo.appName() << " _ " << winfo.geometry() << " _ " << winfo.display();
+    if (winfoIt == m_windows.constEnd()) {
+        viewInfo->removeWindow(wid);
+        return;
+    }
 
-        if (isActive(winfo)) {
-            foundActive = true;
-        }
+    const WindowInfoWrap &winfo = winfoIt.value();
 
-        if (isActiveInViewScreen(view, winfo)) {
-            foundActiveInCurScreen = true;
-            activeWinId = winfo.wid();
-        }
+    bool tracked = (m_wm->inCurrentDesktopActivity(winfo)
+                    && !m_wm->hasBlockedTracking(winfo.wid())
+                    && !winfo.isMinimized());
 
-        //! Maximized windows flags
-        if ((winfo.isActive() && isMaximizedInViewScreen(view, winfo)) //! active maximized windows have higher priority than the rest maximized windows
-                || (!foundMaximizedInCurScreen && isMaximizedInViewScreen(view, winfo))) {
-            foundMaximizedInCurScreen = true;
-            maxWinId = winfo.wid();
-        }
+    //qDebug() << "TRACKING | WINDOW INFO :: " << winfo.wid() << " _ " << winfo.appName() << " _ " << winfo.geometry() << " _ " << winfo.display();
+
+    viewInfo->setWindowActive(wid, tracked && isActiveInViewScreen(view, winfo));
+    viewInfo->setWindowMaximized(wid, tracked && isMaximizedInViewScreen(view, winfo), winfo.isActive());
+    viewInfo->setWindowTouching(wid, tracked && isTouchingView(view, winfo), winfo.isActive());
+    viewInfo->setWindowTouchingEdge(wid, tracked && isTouchingViewEdge(view, winfo), winfo.isActive());
+}
 
-        //! Touching windows flags
+void Windows::trackWindow(Latte::Layout::GenericLayout *layout, const WindowId &wid)
+{
+    TrackedLayoutInfo *layoutInfo = m_layouts[layout];
+    auto winfoIt = m_windows.constFind(wid);
 
-        bool touchingViewEdge = isTouchingViewEdge(view, winfo);
-        bool touchingView =  isTouchingView(view, winfo);
+    if (winfoIt == m_windows.constEnd()) {
+        layoutInfo->removeWindow(wid);
+        return;
+    }
 
-        if (touchingView) {
-            if (winfo.isActive()) {
-                foundActiveTouchInCurScreen = true;
-                activeTouchWinId = winfo.wid();
-            } else {
-                foundTouchInCurScreen = true;
-                touchWinId = winfo.wid();
-            }
-        }
+    const WindowInfoWrap &winfo = winfoIt.value();
 
-        if (touchingViewEdge) {
-            if (winfo.isActive()) {
-                foundActiveEdgeTouchInCurScreen = true;
-                activeTouchEdgeWinId = winfo.wid();
-            } else {
-                foundTouchEdgeInCurScreen = true;
-                touchEdgeWinId = winfo.wid();
-            }
-        }
+    bool tracked = (m_wm->inCurrentDesktopActivity(winfo)
+                    && !m_wm->hasBlockedTracking(winfo.wid())
+                    && !winfo.isMinimized());
+
+    layoutInfo->setWindowActive(wid, tracked && isActive(winfo));
+    layoutInfo->setWindowMaximized(wid, tracked && winfo.isMaximized(), isActive(winfo));
+}
+
+void Windows::updateHints(Latte::View *view)
+{
+    if (!m_views.contains(view)) {
+        return;
+    }
+
+    TrackedViewInfo *viewInfo = m_views[view];
+
+    if (!viewInfo->enabled() || !viewInfo->isTrackingCurrentActivity()) {
+        viewInfo->clearWindows();
+        return;
+    }
+
+    //qDebug() << " -- TRACKING REPORT (SCREEN)--";
+
+    //! rebuild windows sets from scratch, windows outside the view edge band can only be active or maximized
+    updateEdgeBand(view);
+    viewInfo->clearWindows();
 
-        //qDebug() << "TRACKING |       ACTIVE:"<< foundActive <<  " ACT_CUR_SCR:" << foundTouchInCurScreen << " MAXIM:"<<foundMaximizedInCurScreen;
-        //qDebug() << "TRACKING |       TOUCHING VIEW EDGE:"<< touchingViewEdge << " TOUCHING VIEW:" << foundTouchInCurScreen;
+    for (const auto &wid : m_index.candidateWindows(view)) {
+        trackWindow(view, wid);
     }
 
-    if (existsFaultyWindow) {
+    viewInfo->setWindowsSynced(true);
+
+    if (m_index.hasFaultyWindows()) {
         cleanupFaultyWindows();
     }
 
-    //! PASS 2
-    if (foundActiveInCurScreen && !foundActiveTouchInCurScreen) {
-        //! Second Pass to track also Child windows if needed
+    applyHints(view);
+}
 
-        //qDebug() << "Windows Array...";
-        //for (const auto &winfo : m_windows) {
-        //    qDebug() << " - " << winfo.wid() << " - " << winfo.isValid() << " - " << winfo.display() << " - " << winfo.geometry() << " parent : " << winfo.parentId();
-        //}
-        //qDebug() << " - - - - - ";
+void Windows::updateWindowHints(Latte::View *view, const QList<WindowId> &wids)
+{
+    if (!m_views.contains(view)) {
+        return;
+    }
 
-        WindowInfoWrap activeInfo = m_windows[activeWinId];
-        WindowId mainWindowId = activeInfo.isChildWindow() ? activeInfo.parentId() : activeWinId;
+    TrackedViewInfo *viewInfo = m_views[view];
 
-        for (const auto &winfo : m_windows) {
-            if (!m_wm->inCurrentDesktopActivity(winfo)
-                    || m_wm->hasBlockedTracking(winfo.wid())
-                    || winfo.isMinimized()) {
-                continue;
-            }
+    if (!viewInfo->enabled() || !viewInfo->isTrackingCurrentActivity()) {
+        viewInfo->clearWindows();
+        return;
+    }
 
-            bool inActiveGroup = (winfo.wid() == mainWindowId || winfo.parentId() == mainWindowId);
+    //! view moved or it was not tracking windows until now, so its windows sets are outdated
+    if (updateEdgeBand(view) || !viewInfo->windowsSynced()) {
+        updateHints(view);
+        return;
+    }
 
-            //! consider only windows that belong to active window group meaning the main window
-            //! and its children
-            if (!inActiveGroup) {
-                continue;
-            }
+    for (const auto &wid : wids) {
+        trackWindow(view, wid);
+    }
+
+    applyHints(view);
+}
+
+void Windows::applyHints(Latte::View *view)
+{
+    TrackedViewInfo *viewInfo = m_views[view];
+
+    const WindowsSet &activeWindows = viewInfo->activeWindows();
+    const WindowsSet &maximizedWindows = viewInfo->maximizedWindows();
+    const WindowsSet &touchingWindows = viewInfo->touchingWindows();
+    const WindowsSet &touchingEdgeWindows = viewInfo->touchingEdgeWindows();
+
+    bool foundActiveInCurScreen{!activeWindows.isEmpty()};
+    bool foundActiveTouchInCurScreen{touchingWindows.hasActive()};
+    bool foundActiveEdgeTouchInCurScreen{touchingEdgeWindows.hasActive()};
+    bool foundTouchInCurScreen{touchingWindows.hasInactive()};
+    bool foundTouchEdgeInCurScreen{touchingEdgeWindows.hasInactive()};
+    bool foundMaximizedInCurScreen{!maximizedWindows.isEmpty()};
 
-            if (isTouchingView(view, winfo)) {
+    bool foundActiveGroupTouchInCurScreen{false};
+
+    WindowId activeWinId = activeWindows.lastWindow();
+    WindowId touchWinId = touchingWindows.lastInactiveWindow();
+    WindowId touchEdgeWinId = touchingEdgeWindows.lastInactiveWindow();
+    WindowId activeTouchWinId = touchingWindows.lastActiveWindow();
+    WindowId activeTouchEdgeWinId = touchingEdgeWindows.lastActiveWindow();
+
+    //! active maximized windows have higher priority than the rest maximized windows
+    WindowId maxWinId = maximizedWindows.hasActive() ? maximizedWindows.lastActiveWindow() : maximizedWindows.firstWindow();
+
+    //! Second Pass to track also Child windows if needed
+    if (foundActiveInCurScreen && !foundActiveTouchInCurScreen) {
+        WindowInfoWrap activeInfo = infoFor(activeWinId);
+        WindowId mainWindowId = activeInfo.isChildWindow() ? activeInfo.parentId() : activeWinId;
+
+        //! consider only windows that belong to active window group meaning the main window
+        //! and its children
+        for (const auto &wid : touchingWindows.windows()) {
+            if (wid == mainWindowId || infoFor(wid).parentId() == mainWindowId) {
                 foundActiveGroupTouchInCurScreen = true;
                 break;
             }
         }
     }
 
-
     //! HACK: KWin Effects such as ShowDesktop have no way to be identified and as such
     //! create issues with identifying properly touching and maximized windows. BUT when
     //! they are enabled then NO ACTIVE window is found. This is a way to identify these
@@ -1022,7 +1107,7 @@ void Windows::updateHints(Latte::View *view)
 
     //! update LastActiveWindow
     if (foundActiveInCurScreen) {
-        m_views[view]->setActiveWindow(activeWinId);
+        viewInfo->setActiveWindow(activeWinId);
     }
 
     //! Debug
@@ -1035,55 +1120,73 @@ void Windows::updateHints(Latte::View *view)
     //qDebug() << "TRACKING | existsActiveGroupTouching: " << foundActiveGroupTouchInCurScreen;
 }
 
-void Windows::updateHints(Latte::Layout::GenericLayout *layout) {
-    if (!m_layouts.contains(layout) || !m_layouts[layout]->enabled() || !m_layouts[layout]->isTrackingCurrentActivity()) {
+void Windows::updateHints(Latte::Layout::GenericLayout *layout)
+{
+    if (!m_layouts.contains(layout)) {
         return;
     }
 
-    bool foundActive{false};
-    bool foundActiveMaximized{false};
-    bool foundMaximized{false};
+    TrackedLayoutInfo *layoutInfo = m_layouts[layout];
 
-    //! the notification window is not sending a remove signal and creates windows of geometry (0x0 0,0),
-    //! maybe a garbage collector here is a good idea!!!
-    bool existsFaultyWindow{false};
+    if (!layoutInfo->enabled() || !layoutInfo->isTrackingCurrentActivity()) {
+        layoutInfo->clearWindows();
+        return;
+    }
 
-    WindowId activeWinId;
-    WindowId maxWinId;
+    //! layouts are tracking only active and maximized windows
+    layoutInfo->clearWindows();
 
-    for (const auto &winfo : m_windows) {
-        if (!existsFaultyWindow && (winfo.wid()<=0 || winfo.geometry() == QRect(0, 0, 0, 0))) {
-            existsFaultyWindow = true;
-        }
+    for (const auto &wid : m_index.candidateWindows()) {
+        trackWindow(layout, wid);
+    }
 
-        if (!m_wm->inCurrentDesktopActivity(winfo)
-                || m_wm->hasBlockedTracking(winfo.wid())
-                || winfo.isMinimized()) {
-            continue;
-        }
+    layoutInfo->setWindowsSynced(true);
 
-        if (isActive(winfo)) {
-            foundActive = true;
-            activeWinId = winfo.wid();
+    if (m_index.hasFaultyWindows()) {
+        cleanupFaultyWindows();
+    }
 
-            if (winfo.isMaximized() && !winfo.isMinimized()) {
-                foundActiveMaximized = true;
-                maxWinId = winfo.wid();
-            }
-        }
+    applyHints(layout);
+}
 
-        if (!foundActiveMaximized && winfo.isMaximized() && !winfo.isMinimized()) {
-            foundMaximized = true;
-            maxWinId = winfo.wid();
-        }
+void Windows::updateWindowHints(Latte::Layout::GenericLayout *layout, const QList<WindowId> &wids)
+{
+    if (!m_layouts.contains(layout)) {
+        return;
+    }
 
-        //qDebug() << "window geometry ::: " << winfo.geometry();
+    TrackedLayoutInfo *layoutInfo = m_layouts[layout];
+
+    if (!layoutInfo->enabled() || !layoutInfo->isTrackingCurrentActivity()) {
+        layoutInfo->clearWindows();
+        return;
     }
 
-    if (existsFaultyWindow) {
-        cleanupFaultyWindows();
+    if (!layoutInfo->windowsSynced()) {
+        updateHints(layout);
+        return;
     }
 
+    for (const auto &wid : wids) {
+        trackWindow(layout, wid);
+    }
+
+    applyHints(layout);
+}
+
+void Windows::applyHints(Latte::Layout::GenericLayout *layout)
+{
+    TrackedLayoutInfo *layoutInfo = m_layouts[layout];
+
+    const WindowsSet &activeWindows = layoutInfo->activeWindows();
+    const WindowsSet &maximizedWindows = layoutInfo->maximizedWindows();
+
+    bool foundActive{!activeWindows.isEmpty()};
+    bool foundActiveMaximized{maximizedWindows.hasActive()};
+    bool foundMaximized{!maximizedWindows.isEmpty()};
+
+    WindowId activeWinId = activeWindows.lastWindow();
+
     //! HACK: KWin Effects such as ShowDesktop have no way to be identified and as such
     //! create issues with identifying properly touching and maximized windows. BUT when
     //! they are enabled then NO ACTIVE window is found. This is a way to identify these
@@ -1097,14 +1200,14 @@ void Windows::updateHints(Latte::Layout::GenericLayout *layout) {
     //! assign flags
     setExistsWindowActive(layout, foundActive);
     setActiveWindowMaximized(layout, foundActiveMaximized);
-    setExistsWindowMaximized(layout, foundActiveMaximized || foundMaximized);
+    setExistsWindowMaximized(layout, foundMaximized);
 
     //! update color schemes for active and touching windows
     setActiveWindowScheme(layout, (foundActive ? m_wm->schemesTracker()->schemeForWindow(activeWinId) : nullptr));
 
     //! update LastActiveWindow
     if (foundActive) {
-        m_layouts[layout]->setActiveWindow(activeWinId);
+        layoutInfo->setActiveWindow(activeWinId);
     }
 
     //! Debug
@@ -22,6 +22,7 @@
 
 // local
 #include <coretypes.h>
+#include "spatialindex.h"
 #include "../windowinfowrap.h"
 
 // Qt
@@ -120,7 +121,7 @@ signals:
     //! overloading WM signals in order to update first m_windows and afterwards
     //! inform consumers for window changes
     void activeWindowChanged(const WindowId &wid);
-    void windowChanged(const WindowId &wid);
+    void windowsChanged(const QList<WindowId> &wids);
     void windowRemoved(const WindowId &wid);
 
     void applicationDataChanged(const WindowId &wid);
@@ -139,13 +140,30 @@ private:
     void initLayoutHints(Latte::Layout::GenericLayout *layout);
     void initViewHints(Latte::View *view);
     void cleanupFaultyWindows();
+    void updateWindow(const WindowId &wid);
+    void updateWindows(const QList<WindowId> &wids);
+    void removeWindow(const WindowId &wid);
 
     void updateAllHints();
+    void updateWindowHints(const QList<WindowId> &wids);
 
     //! Views
+    bool updateEdgeBand(Latte::View *view);
+
+    //! full hints update for all windows
     void updateHints(Latte::View *view);
     void updateHints(Latte::Layout::GenericLayout *layout);
 
+    //! incremental hints update only for the provided windows
+    void updateWindowHints(Latte::View *view, const QList<WindowId> &wids);
+    void updateWindowHints(Latte::Layout::GenericLayout *layout, const QList<WindowId> &wids);
+
+    void trackWindow(Latte::View *view, const WindowId &wid);
+    void trackWindow(Latte::Layout::GenericLayout *layout, const WindowId &wid);
+
+    void applyHints(Latte::View *view);
+    void applyHints(Latte::Layout::GenericLayout *layout);
+
     void setActiveWindowMaximized(Latte::View *view, bool activeMaximized);
     void setActiveWindowTouching(Latte::View *view, bool activeTouching);
     void setActiveWindowTouchingEdge(Latte::View *view, bool activeTouchingEdge);
@@ -194,6 +212,9 @@ private:
 
     QMap<WindowId, WindowInfoWrap> m_windows;
 
+    //! views edge bands and windows near them, it is kept in sync with m_windows
+    SpatialIndex m_index;
+
     //! Some applications delay their application name/icon identification
     //! such as Libreoffice that updates its StartupWMClass after
     //! its startup
@@ -231,7 +231,7 @@ void WaylandInterface::registerIgnoredWindow(WindowId wid)
             untrackWindow(w);
         }
 
-        emit windowChanged(wid);
+        emit windowsChanged({wid});
     }
 }
 
@@ -525,10 +525,11 @@ AppData WaylandInterface::appDataFor(WindowId wid)
     auto window = windowFor(wid);
 
     if (window) {
-        const AppData &data = appDataFromUrl(windowUrlFromMetadata(window->appId(),
-                                                                   window->pid(), rulesConfig));
+        QString identityKey = appIdentityKey(wid, {window->appId()}, window->pid());
 
-        return data;
+        return cachedAppData(identityKey, [this, window]() {
+            return windowUrlFromMetadata(window->appId(), window->pid(), rulesConfig);
+        });
     }
 
     AppData empty;
@@ -0,0 +1,419 @@
+/*
+*  Copyright 2020  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "xwindowdatafetcher.h"
+
+// C++
+#include <cstring>
+
+// Qt
+#include <QMargins>
+#include <QScopedPointer>
+#include <QtX11Extras/QX11Info>
+
+namespace Latte {
+namespace WindowSystem {
+
+#define ALLACTIVITIESID "00000000-0000-0000-0000-000000000000"
+#define MAXSTRINGLENGTH 2048
+#define MAXATOMSLENGTH 1024
+
+namespace {
+using PropertyReply = QScopedPointer<xcb_get_property_reply_t, QScopedPointerPodDeleter>;
+
+QByteArray stringFrom(const PropertyReply &reply)
+{
+    if (!reply || reply->format != 8 || reply->value_len == 0) {
+        return QByteArray();
+    }
+
+    return QByteArray(static_cast<const char *>(xcb_get_property_value(reply.data())), xcb_get_property_value_length(reply.data()));
+}
+
+QList<uint32_t> cardinalsFrom(const PropertyReply &reply)
+{
+    QList<uint32_t> values;
+
+    if (!reply || reply->format != 32) {
+        return values;
+    }
+
+    const uint32_t *data = static_cast<const uint32_t *>(xcb_get_property_value(reply.data()));
+
+    for (uint32_t i=0; i<reply->value_len; ++i) {
+        values << data[i];
+    }
+
+    return values;
+}
+
+QList<xcb_atom_t> atomsFrom(const PropertyReply &reply)
+{
+    QList<xcb_atom_t> atoms;
+
+    for (const auto value : cardinalsFrom(reply)) {
+        atoms << static_cast<xcb_atom_t>(value);
+    }
+
+    return atoms;
+}
+
+//! left, right, top, bottom as both _NET_FRAME_EXTENTS and _GTK_FRAME_EXTENTS are storing them
+QMargins extentsFrom(const PropertyReply &reply)
+{
+    QList<uint32_t> values = cardinalsFrom(reply);
+
+    if (values.count() != 4) {
+        return QMargins();
+    }
+
+    return QMargins(values[0], values[2], values[1], values[3]);
+}
+}
+
+bool XWindowData::hasState(NET::States state) const
+{
+    return (states & state);
+}
+
+bool XWindowData::actionSupported(NET::Actions action) const
+{
+    return (allowedActions & action);
+}
+
+bool XWindowData::onAllDesktops() const
+{
+    return (desktop == NET::OnAllDesktops);
+}
+
+XWindowDataFetcher::XWindowDataFetcher()
+{
+    m_connection = QX11Info::connection();
+    m_rootWindow = QX11Info::appRootWindow();
+}
+
+void XWindowDataFetcher::initAtoms()
+{
+    if (m_atomsInitialized) {
+        return;
+    }
+
+    static const char *names[AtomsCount] = {
+        "_NET_WM_STATE",
+        "_NET_WM_STATE_MODAL",
+        "_NET_WM_STATE_STICKY",
+        "_NET_WM_STATE_MAXIMIZED_VERT",
+        "_NET_WM_STATE_MAXIMIZED_HORZ",
+        "_NET_WM_STATE_SHADED",
+        "_NET_WM_STATE_SKIP_TASKBAR",
+        "_NET_WM_STATE_SKIP_PAGER",
+        "_NET_WM_STATE_HIDDEN",
+        "_NET_WM_STATE_FULLSCREEN",
+        "_NET_WM_STATE_ABOVE",
+        "_NET_WM_STATE_BELOW",
+        "_NET_WM_STATE_DEMANDS_ATTENTION",
+        "_KDE_NET_WM_STATE_SKIP_SWITCHER",
+        "_NET_WM_ALLOWED_ACTIONS",
+        "_NET_WM_ACTION_MOVE",
+        "_NET_WM_ACTION_RESIZE",
+        "_NET_WM_ACTION_MINIMIZE",
+        "_NET_WM_ACTION_SHADE",
+        "_NET_WM_ACTION_STICK",
+        "_NET_WM_ACTION_MAXIMIZE_VERT",
+        "_NET_WM_ACTION_MAXIMIZE_HORZ",
+        "_NET_WM_ACTION_FULLSCREEN",
+        "_NET_WM_ACTION_CHANGE_DESKTOP",
+        "_NET_WM_ACTION_CLOSE",
+        "_NET_WM_DESKTOP",
+        "_NET_WM_NAME",
+        "_NET_WM_VISIBLE_NAME",
+        "_NET_FRAME_EXTENTS",
+        "_GTK_FRAME_EXTENTS",
+        "_KDE_NET_WM_ACTIVITIES",
+        "UTF8_STRING"
+    };
+
+    //! pipeline also the atoms requests
+    xcb_intern_atom_cookie_t cookies[AtomsCount];
+
+    for (int i=0; i<AtomsCount; ++i) {
+        cookies[i] = xcb_intern_atom(m_connection, false, strlen(names[i]), names[i]);
+    }
+
+    for (int i=0; i<AtomsCount; ++i) {
+        QScopedPointer<xcb_intern_atom_reply_t, QScopedPointerPodDeleter> reply(xcb_intern_atom_reply(m_connection, cookies[i], nullptr));
+        m_atoms[i] = reply ? reply->atom : XCB_ATOM_NONE;
+    }
+
+    m_atomsInitialized = true;
+}
+
+void XWindowDataFetcher::invalidate(WId wid, NET::Properties2 properties2)
+{
+    if (!m_staticData.contains(wid)) {
+        return;
+    }
+
+    if (properties2 & NET::WM2WindowClass) {
+        m_staticData[wid].hasWindowClass = false;
+    }
+
+    if (properties2 & NET::WM2AllowedActions) {
+        m_staticData[wid].hasAllowedActions = false;
+    }
+}
+
+void XWindowDataFetcher::remove(WId wid)
+{
+    m_staticData.remove(wid);
+}
+
+XWindowData XWindowDataFetcher::fetch(WId wid)
+{
+    return fetch(QList<WId>({wid})).value(wid);
+}
+
+QHash<WId, XWindowData> XWindowDataFetcher::fetch(const QList<WId> &wids)
+{
+    QHash<WId, XWindowData> data;
+
+    if (!m_connection || wids.isEmpty()) {
+        return data;
+    }
+
+    initAtoms();
+
+    //! send all requests first...
+    QList<Cookies> requests;
+
+    for (const auto wid : wids) {
+        requests << sendRequests(wid);
+    }
+
+    //! ...and collect their replies afterwards
+    for (const auto &cookies : requests) {
+        data[cookies.wid] = collectReplies(cookies);
+    }
+
+    return data;
+}
+
+xcb_get_property_cookie_t XWindowDataFetcher::requestProperty(WId wid, xcb_atom_t property, xcb_atom_t type, uint32_t length)
+{
+    return xcb_get_property(m_connection, false, wid, property, type, 0, length);
+}
+
+XWindowDataFetcher::Cookies XWindowDataFetcher::sendRequests(WId wid)
+{
+    Cookies cookies;
+    cookies.wid = wid;
+
+    cookies.geometry = xcb_get_geometry(m_connection, wid);
+    cookies.translate = xcb_translate_coordinates(m_connection, wid, m_rootWindow, 0, 0);
+    cookies.state = requestProperty(wid, m_atoms[NetWmState], XCB_ATOM_ATOM, MAXATOMSLENGTH);
+    cookies.desktop = requestProperty(wid, m_atoms[NetWmDesktop], XCB_ATOM_CARDINAL, 1);
+    cookies.transientFor = requestProperty(wid, XCB_ATOM_WM_TRANSIENT_FOR, XCB_ATOM_WINDOW, 1);
+    cookies.frameExtents = requestProperty(wid, m_atoms[NetFrameExtents], XCB_ATOM_CARDINAL, 4);
+    cookies.gtkFrameExtents = requestProperty(wid, m_atoms[GtkFrameExtents], XCB_ATOM_CARDINAL, 4);
+    cookies.visibleName = requestProperty(wid, m_atoms[NetWmVisibleName], m_atoms[Utf8String], MAXSTRINGLENGTH);
+    cookies.name = requestProperty(wid, m_atoms[NetWmName], m_atoms[Utf8String], MAXSTRINGLENGTH);
+    cookies.wmName = requestProperty(wid, XCB_ATOM_WM_NAME, XCB_GET_PROPERTY_TYPE_ANY, MAXSTRINGLENGTH);
+    cookies.activities = requestProperty(wid, m_atoms[KdeNetWmActivities], XCB_ATOM_STRING, MAXSTRINGLENGTH);
+
+    const StaticData staticData = m_staticData.value(wid);
+
+    cookies.requestWindowClass = !staticData.hasWindowClass;
+    cookies.requestAllowedActions = !staticData.hasAllowedActions;
+
+    if (cookies.requestWindowClass) {
+        cookies.windowClass = requestProperty(wid, XCB_ATOM_WM_CLASS, XCB_ATOM_STRING, MAXSTRINGLENGTH);
+    }
+
+    if (cookies.requestAllowedActions) {
+        cookies.allowedActions = requestProperty(wid, m_atoms[NetWmAllowedActions], XCB_ATOM_ATOM, MAXATOMSLENGTH);
+    }
+
+    return cookies;
+}
+
+XWindowData XWindowDataFetcher::collectReplies(const Cookies &cookies)
+{
+    XWindowData data;
+
+    //! all replies must be collected even for invalid windows in order to not leak them
+    QScopedPointer<xcb_get_geometry_reply_t, QScopedPointerPodDeleter> geometry(xcb_get_geometry_reply(m_connection, cookies.geometry, nullptr));
+    QScopedPointer<xcb_translate_coordinates_reply_t, QScopedPointerPodDeleter> translate(xcb_translate_coordinates_reply(m_connection, cookies.translate, nullptr));
+    PropertyReply state(xcb_get_property_reply(m_connection, cookies.state, nullptr));
+    PropertyReply desktop(xcb_get_property_reply(m_connection, cookies.desktop, nullptr));
+    PropertyReply transientFor(xcb_get_property_reply(m_connection, cookies.transientFor, nullptr));
+    PropertyReply frameExtents(xcb_get_property_reply(m_connection, cookies.frameExtents, nullptr));
+    PropertyReply gtkFrameExtents(xcb_get_property_reply(m_connection, cookies.gtkFrameExtents, nullptr));
+    PropertyReply visibleName(xcb_get_property_reply(m_connection, cookies.visibleName, nullptr));
+    PropertyReply name(xcb_get_property_reply(m_connection, cookies.name, nullptr));
+    PropertyReply wmName(xcb_get_property_reply(m_connection, cookies.wmName, nullptr));
+    PropertyReply activities(xcb_get_property_reply(m_connection, cookies.activities, nullptr));
+    PropertyReply windowClass(cookies.requestWindowClass ? xcb_get_property_reply(m_connection, cookies.windowClass, nullptr) : nullptr);
+    PropertyReply allowedActions(cookies.requestAllowedActions ? xcb_get_property_reply(m_connection, cookies.allowedActions, nullptr) : nullptr);
+
+    if (!geometry || !translate) {
+        //! window has already been destroyed
+        m_staticData.remove(cookies.wid);
+        return data;
+    }
+
+    data.isValid = true;
+
+    //! Geometry
+    QRect frameGeometry(translate->dst_x, translate->dst_y, geometry->width, geometry->height);
+    frameGeometry += extentsFrom(frameExtents);
+
+    QMargins gtkMargins = extentsFrom(gtkFrameExtents);
+
+    if (!gtkMargins.isNull()) {
+        frameGeometry -= gtkMargins;
+    }
+
+    data.geometry = frameGeometry;
+
+    //! State
+    data.states = statesFrom(atomsFrom(state));
+
+    //! Desktop, desktops are counted from 1 in NET
+    QList<uint32_t> desktops = cardinalsFrom(desktop);
+
+    if (!desktops.isEmpty()) {
+        data.desktop = (desktops[0] == 0xFFFFFFFF) ? NET::OnAllDesktops : static_cast<int>(desktops[0]) + 1;
+    }
+
+    //! Transient
+    QList<uint32_t> transients = cardinalsFrom(transientFor);
+    data.transientFor = transients.isEmpty() ? 0 : transients[0];
+
+    //! Name
+    QByteArray nameValue = stringFrom(visibleName);
+
+    if (nameValue.isEmpty()) {
+        nameValue = stringFrom(name);
+    }
+
+    data.visibleName = nameValue.isEmpty() ? QString::fromLocal8Bit(stringFrom(wmName)) : QString::fromUtf8(nameValue);
+
+    //! Activities, empty activities means all activities
+    QString activitiesValue = QString::fromUtf8(stringFrom(activities));
+
+    if (!activitiesValue.isEmpty() && activitiesValue != QLatin1String(ALLACTIVITIESID)) {
+        data.activities = activitiesValue.split(QLatin1Char(','), QString::SkipEmptyParts);
+    }
+
+    //! Static Data
+    StaticData &staticData = m_staticData[cookies.wid];
+
+    if (cookies.requestWindowClass) {
+        //! WM_CLASS contains two consecutive null terminated strings, instance name and class name
+        QList<QByteArray> classParts = stringFrom(windowClass).split('\0');
+        staticData.windowClassName = classParts.count() > 0 ? classParts[0] : QByteArray();
+        staticData.windowClassClass = classParts.count() > 1 ? classParts[1] : QByteArray();
+        staticData.hasWindowClass = true;
+    }
+
+    if (cookies.requestAllowedActions) {
+        staticData.allowedActions = actionsFrom(atomsFrom(allowedActions));
+        staticData.hasAllowedActions = true;
+    }
+
+    data.windowClassName = staticData.windowClassName;
+    data.windowClassClass = staticData.windowClassClass;
+    data.allowedActions = staticData.allowedActions;
+
+    return data;
+}
+
+NET::States XWindowDataFetcher::statesFrom(const QList<xcb_atom_t> &atoms) const
+{
+    NET::States states;
+
+    for (const auto atom : atoms) {
+        if (atom == m_atoms[NetWmStateModal]) {
+            states |= NET::Modal;
+        } else if (atom == m_atoms[NetWmStateSticky]) {
+            states |= NET::Sticky;
+        } else if (atom == m_atoms[NetWmStateMaxVert]) {
+            states |= NET::MaxVert;
+        } else if (atom == m_atoms[NetWmStateMaxHoriz]) {
+            states |= NET::MaxHoriz;
+        } else if (atom == m_atoms[NetWmStateShaded]) {
+            states |= NET::Shaded;
+        } else if (atom == m_atoms[NetWmStateSkipTaskbar]) {
+            states |= NET::SkipTaskbar;
+        } else if (atom == m_atoms[NetWmStateSkipPager]) {
+            states |= NET::SkipPager;
+        } else if (atom == m_atoms[NetWmStateHidden]) {
+            states |= NET::Hidden;
+        } else if (atom == m_atoms[NetWmStateFullScreen]) {
+            states |= NET::FullScreen;
+        } else if (atom == m_atoms[NetWmStateAbove]) {
+            states |= NET::KeepAbove;
+        } else if (atom == m_atoms[NetWmStateBelow]) {
+            states |= NET::KeepBelow;
+        } else if (atom == m_atoms[NetWmStateDemandsAttention]) {
+            states |= NET::DemandsAttention;
+        }
+#if KF5_VERSION_MINOR >= 45
+        else if (atom == m_atoms[KdeNetWmStateSkipSwitcher]) {
+            states |= NET::SkipSwitcher;
+        }
+#endif
+    }
+
+    return states;
+}
+
+NET::Actions XWindowDataFetcher::actionsFrom(const QList<xcb_atom_t> &atoms) const
+{
+    NET::Actions actions;
+
+    for (const auto atom : atoms) {
+        if (atom == m_atoms[NetWmActionMove]) {
+            actions |= NET::ActionMove;
+        } else if (atom == m_atoms[NetWmActionResize]) {
+            actions |= NET::ActionResize;
+        } else if (atom == m_atoms[NetWmActionMinimize]) {
+            actions |= NET::ActionMinimize;
+        } else if (atom == m_atoms[NetWmActionShade]) {
+            actions |= NET::ActionShade;
+        } else if (atom == m_atoms[NetWmActionStick]) {
+            actions |= NET::ActionStick;
+        } else if (atom == m_atoms[NetWmActionMaxVert]) {
+            actions |= NET::ActionMaxVert;
+        } else if (atom == m_atoms[NetWmActionMaxHoriz]) {
+            actions |= NET::ActionMaxHoriz;
+        } else if (atom == m_atoms[NetWmActionFullScreen]) {
+            actions |= NET::ActionFullScreen;
+        } else if (atom == m_atoms[NetWmActionChangeDesktop]) {
+            actions |= NET::ActionChangeDesktop;
+        } else if (atom == m_atoms[NetWmActionClose]) {
+            actions |= NET::ActionClose;
+        }
+    }
+
+    return actions;
+}
+
+}
+}
@@ -0,0 +1,173 @@
+/*
+*  Copyright 2020  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef XWINDOWDATAFETCHER_H
+#define XWINDOWDATAFETCHER_H
+
+// local
+#include <config-latte.h>
+
+// Qt
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QRect>
+#include <QString>
+#include <QStringList>
+#include <QWindow>
+
+// X11
+#include <NETWM>
+#include <xcb/xcb.h>
+
+namespace Latte {
+namespace WindowSystem {
+
+//! Raw window properties as they are read from the X server
+struct XWindowData
+{
+    bool isValid{false};
+
+    //! frame geometry including decorations but without gtk client side shadows
+    QRect geometry;
+
+    NET::States states;
+    NET::Actions allowedActions;
+
+    int desktop{0};
+    WId transientFor{0};
+
+    QByteArray windowClassName;
+    QByteArray windowClassClass;
+
+    QString visibleName;
+    QStringList activities;
+
+    bool hasState(NET::States state) const;
+    bool actionSupported(NET::Actions action) const;
+    bool onAllDesktops() const;
+};
+
+//! Fetches windows properties through xcb in a pipelined way. For all requested
+//! windows all property cookies are sent first and only afterwards the replies are
+//! collected, so a batch of windows costs a single round trip instead of several
+//! blocking KWindowInfo round trips per window. Window class and allowed actions are
+//! static for almost all windows and are cached until a related property change is reported.
+class XWindowDataFetcher
+{
+public:
+    XWindowDataFetcher();
+
+    XWindowData fetch(WId wid);
+    QHash<WId, XWindowData> fetch(const QList<WId> &wids);
+
+    //! drop cached static properties that have been changed
+    void invalidate(WId wid, NET::Properties2 properties2);
+    void remove(WId wid);
+
+private:
+    enum Atom {
+        NetWmState = 0,
+        NetWmStateModal,
+        NetWmStateSticky,
+        NetWmStateMaxVert,
+        NetWmStateMaxHoriz,
+        NetWmStateShaded,
+        NetWmStateSkipTaskbar,
+        NetWmStateSkipPager,
+        NetWmStateHidden,
+        NetWmStateFullScreen,
+        NetWmStateAbove,
+        NetWmStateBelow,
+        NetWmStateDemandsAttention,
+        KdeNetWmStateSkipSwitcher,
+        NetWmAllowedActions,
+        NetWmActionMove,
+        NetWmActionResize,
+        NetWmActionMinimize,
+        NetWmActionShade,
+        NetWmActionStick,
+        NetWmActionMaxVert,
+        NetWmActionMaxHoriz,
+        NetWmActionFullScreen,
+        NetWmActionChangeDesktop,
+        NetWmActionClose,
+        NetWmDesktop,
+        NetWmName,
+        NetWmVisibleName,
+        NetFrameExtents,
+        GtkFrameExtents,
+        KdeNetWmActivities,
+        Utf8String,
+        AtomsCount
+    };
+
+    struct StaticData {
+        bool hasWindowClass{false};
+        bool hasAllowedActions{false};
+
+        QByteArray windowClassName;
+        QByteArray windowClassClass;
+        NET::Actions allowedActions;
+    };
+
+    struct Cookies {
+        WId wid{0};
+        bool requestWindowClass{false};
+        bool requestAllowedActions{false};
+
+        xcb_get_geometry_cookie_t geometry;
+        xcb_translate_coordinates_cookie_t translate;
+        xcb_get_property_cookie_t state;
+        xcb_get_property_cookie_t desktop;
+        xcb_get_property_cookie_t transientFor;
+        xcb_get_property_cookie_t frameExtents;
+        xcb_get_property_cookie_t gtkFrameExtents;
+        xcb_get_property_cookie_t visibleName;
+        xcb_get_property_cookie_t name;
+        xcb_get_property_cookie_t wmName;
+        xcb_get_property_cookie_t activities;
+        xcb_get_property_cookie_t windowClass;
+        xcb_get_property_cookie_t allowedActions;
+    };
+
+    void initAtoms();
+
+    Cookies sendRequests(WId wid);
+    XWindowData collectReplies(const Cookies &cookies);
+
+    xcb_get_property_cookie_t requestProperty(WId wid, xcb_atom_t property, xcb_atom_t type, uint32_t length);
+
+    NET::States statesFrom(const QList<xcb_atom_t> &atoms) const;
+    NET::Actions actionsFrom(const QList<xcb_atom_t> &atoms) const;
+
+private:
+    bool m_atomsInitialized{false};
+    xcb_atom_t m_atoms[AtomsCount];
+
+    xcb_connection_t *m_connection{nullptr};
+    xcb_window_t m_rootWindow{0};
+
+    QHash<WId, StaticData> m_staticData;
+};
+
+}
+}
+
+#endif
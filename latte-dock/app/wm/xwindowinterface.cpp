@@ -50,6 +50,10 @@ XWindowInterface::XWindowInterface(QObject *parent)
     m_currentDesktop = QString(KWindowSystem::self()->currentDesktop());
 
     connect(KWindowSystem::self(), &KWindowSystem::activeWindowChanged, this, &AbstractWindowInterface::activeWindowChanged);
+    connect(KWindowSystem::self(), &KWindowSystem::windowRemoved, this, [&](WId wid) {
+        m_dataFetcher.remove(wid);
+        m_prefetchedData.remove(wid);
+    });
     connect(KWindowSystem::self(), &KWindowSystem::windowRemoved, this, &AbstractWindowInterface::windowRemoved);
 
     connect(KWindowSystem::self(), &KWindowSystem::windowAdded, this, &XWindowInterface::windowAddedProxy);
@@ -65,6 +69,9 @@ XWindowInterface::XWindowInterface(QObject *parent)
             , this, &XWindowInterface::windowChangedProxy);
 
 
+    //! fetch all windows at once during startup
+    m_prefetchedData = m_dataFetcher.fetch(KWindowSystem::self()->windows());
+
     for(auto wid : KWindowSystem::self()->windows()) {
         windowAddedProxy(wid);
     }
@@ -92,6 +99,19 @@ void XWindowInterface::setViewExtraFlags(QObject *view,bool isPanelWindow, Latte
         }
     }
 
+    if (winId == (WId)-1) {
+        //! plain windows such as the layout dormant views
+        QWindow *window = qobject_cast<QWindow *>(view);
+
+        if (window) {
+            winId = window->winId();
+        }
+    }
+
+    if (winId == (WId)-1) {
+        return;
+    }
+
     NETWinInfo winfo(QX11Info::connection()
                      , static_cast<xcb_window_t>(winId)
                      , static_cast<xcb_window_t>(winId)
@@ -327,21 +347,6 @@ void XWindowInterface::setActiveEdge(QWindow *view, bool active)
     xcb_change_property(c, XCB_PROP_MODE_REPLACE, window->winId(), atom->atom, XCB_ATOM_CARDINAL, 32, 1, &value);
 }
 
-#if KF5_VERSION_MINOR >= 65
-QRect XWindowInterface::visibleGeometry(const WindowId &wid, const QRect &frameGeometry) const
-{
-    NETWinInfo ni(QX11Info::connection(), wid.toUInt(), QX11Info::appRootWindow(), 0, NET::WM2GTKFrameExtents);
-    NETStrut struts = ni.gtkFrameExtents();
-    QMargins margins(struts.left, struts.top, struts.right, struts.bottom);
-    QRect visibleGeometry = frameGeometry;
-
-    if (!margins.isNull()) {
-        visibleGeometry -= margins;
-    }
-
-    return visibleGeometry;
-}
-#endif
 
 
 void XWindowInterface::setFrameExtents(QWindow *view, const QMargins &margins)
@@ -392,61 +397,83 @@ WindowInfoWrap XWindowInterface::requestInfoActive()
 
 WindowInfoWrap XWindowInterface::requestInfo(WindowId wid)
 {
-    const KWindowInfo winfo{wid.value<WId>(), NET::WMFrameExtents
-                | NET::WMWindowType
-                | NET::WMGeometry
-                | NET::WMDesktop
-                | NET::WMState
-                | NET::WMName
-                | NET::WMVisibleName,
-                NET::WM2WindowClass
-                | NET::WM2Activities
-                | NET::WM2AllowedActions
-                | NET::WM2TransientFor};
+    WId xwid = wid.value<WId>();
+
+    if (m_prefetchedData.contains(xwid)) {
+        return infoFromData(wid, m_prefetchedData.take(xwid));
+    }
+
+    return infoFromData(wid, m_dataFetcher.fetch(xwid));
+}
+
+QList<WindowInfoWrap> XWindowInterface::requestInfos(const QList<WindowId> &wids)
+{
+    QList<WId> pendingWids;
+
+    for (const auto &wid : wids) {
+        WId xwid = wid.value<WId>();
+
+        if (!m_prefetchedData.contains(xwid) && !pendingWids.contains(xwid)) {
+            pendingWids << xwid;
+        }
+    }
+
+    //! a single round trip for all windows that have not been fetched yet
+    QHash<WId, XWindowData> fetchedData = m_dataFetcher.fetch(pendingWids);
 
+    QList<WindowInfoWrap> infos;
+
+    for (const auto &wid : wids) {
+        WId xwid = wid.value<WId>();
+        XWindowData data = m_prefetchedData.contains(xwid) ? m_prefetchedData.take(xwid) : fetchedData.value(xwid);
+
+        infos << infoFromData(wid, data);
+    }
+
+    return infos;
+}
+
+WindowInfoWrap XWindowInterface::infoFromData(WindowId wid, const XWindowData &data)
+{
     WindowInfoWrap winfoWrap;
 
-    if (!winfo.valid()) {
+    if (!data.isValid) {
         winfoWrap.setIsValid(false);
-    } else if (isValidWindow(wid)) {
+    } else if (isValidWindow(wid, data)) {
         winfoWrap.setIsValid(true);
         winfoWrap.setWid(wid);
-        winfoWrap.setParentId(winfo.transientFor());
+        winfoWrap.setParentId(data.transientFor);
         winfoWrap.setIsActive(KWindowSystem::activeWindow() == wid.value<WId>());
-        winfoWrap.setIsMinimized(winfo.hasState(NET::Hidden));
-        winfoWrap.setIsMaxVert(winfo.hasState(NET::MaxVert));
-        winfoWrap.setIsMaxHoriz(winfo.hasState(NET::MaxHoriz));
-        winfoWrap.setIsFullscreen(winfo.hasState(NET::FullScreen));
-        winfoWrap.setIsShaded(winfo.hasState(NET::Shaded));
-        winfoWrap.setIsOnAllDesktops(winfo.onAllDesktops());
-        winfoWrap.setIsOnAllActivities(winfo.activities().empty());
-#if KF5_VERSION_MINOR >= 65
-        winfoWrap.setGeometry(visibleGeometry(wid, winfo.frameGeometry()));
-#else
-        winfoWrap.setGeometry(winfo.frameGeometry());
-#endif
-        winfoWrap.setIsKeepAbove(winfo.hasState(NET::KeepAbove));
-        winfoWrap.setIsKeepBelow(winfo.hasState(NET::KeepBelow));
-        winfoWrap.setHasSkipPager(winfo.hasState(NET::SkipPager));
+        winfoWrap.setIsMinimized(data.hasState(NET::Hidden));
+        winfoWrap.setIsMaxVert(data.hasState(NET::MaxVert));
+        winfoWrap.setIsMaxHoriz(data.hasState(NET::MaxHoriz));
+        winfoWrap.setIsFullscreen(data.hasState(NET::FullScreen));
+        winfoWrap.setIsShaded(data.hasState(NET::Shaded));
+        winfoWrap.setIsOnAllDesktops(data.onAllDesktops());
+        winfoWrap.setIsOnAllActivities(data.activities.empty());
+        winfoWrap.setGeometry(data.geometry);
+        winfoWrap.setIsKeepAbove(data.hasState(NET::KeepAbove));
+        winfoWrap.setIsKeepBelow(data.hasState(NET::KeepBelow));
+        winfoWrap.setHasSkipPager(data.hasState(NET::SkipPager));
 #if KF5_VERSION_MINOR >= 45
-        winfoWrap.setHasSkipSwitcher(winfo.hasState(NET::SkipSwitcher));
+        winfoWrap.setHasSkipSwitcher(data.hasState(NET::SkipSwitcher));
 #endif
-        winfoWrap.setHasSkipTaskbar(winfo.hasState(NET::SkipTaskbar));
+        winfoWrap.setHasSkipTaskbar(data.hasState(NET::SkipTaskbar));
 
         //! BEGIN:Window Abilities
-        winfoWrap.setIsClosable(winfo.actionSupported(NET::ActionClose));
-        winfoWrap.setIsFullScreenable(winfo.actionSupported(NET::ActionFullScreen));
-        winfoWrap.setIsMaximizable(winfo.actionSupported(NET::ActionMax));
-        winfoWrap.setIsMinimizable(winfo.actionSupported(NET::ActionMinimize));
-        winfoWrap.setIsMovable(winfo.actionSupported(NET::ActionMove));
-        winfoWrap.setIsResizable(winfo.actionSupported(NET::ActionResize));
-        winfoWrap.setIsShadeable(winfo.actionSupported(NET::ActionShade));
-        winfoWrap.setIsVirtualDesktopsChangeable(winfo.actionSupported(NET::ActionChangeDesktop));
+        winfoWrap.setIsClosable(data.actionSupported(NET::ActionClose));
+        winfoWrap.setIsFullScreenable(data.actionSupported(NET::ActionFullScreen));
+        winfoWrap.setIsMaximizable(data.actionSupported(NET::ActionMax));
+        winfoWrap.setIsMinimizable(data.actionSupported(NET::ActionMinimize));
+        winfoWrap.setIsMovable(data.actionSupported(NET::ActionMove));
+        winfoWrap.setIsResizable(data.actionSupported(NET::ActionResize));
+        winfoWrap.setIsShadeable(data.actionSupported(NET::ActionShade));
+        winfoWrap.setIsVirtualDesktopsChangeable(data.actionSupported(NET::ActionChangeDesktop));
         //! END:Window Abilities
 
-        winfoWrap.setDisplay(winfo.visibleName());
-        winfoWrap.setDesktops({QString(winfo.desktop())});
-        winfoWrap.setActivities(winfo.activities());
+        winfoWrap.setDisplay(data.visibleName);
+        winfoWrap.setDesktops({QString(data.desktop)});
+        winfoWrap.setActivities(data.activities);
     }
 
     return winfoWrap;
@@ -454,7 +481,16 @@ WindowInfoWrap XWindowInterface::requestInfo(WindowId wid)
 
 AppData XWindowInterface::appDataFor(WindowId wid)
 {
-    return appDataFromUrl(windowUrl(wid));
+    const KWindowInfo info(wid.value<WId>(), 0, NET::WM2WindowClass | NET::WM2DesktopFileName);
+    const quint32 pid = NETWinInfo(QX11Info::connection(), wid.value<WId>(), QX11Info::appRootWindow(), NET::WMPid, NET::Properties2()).pid();
+
+    QString identityKey = appIdentityKey(wid, {QString::fromUtf8(info.desktopFileName()),
+                                               QString::fromUtf8(info.windowClassClass()),
+                                               QString::fromUtf8(info.windowClassName())}, pid);
+
+    return cachedAppData(identityKey, [this, wid]() {
+        return windowUrl(wid);
+    });
 }
 
 QUrl XWindowInterface::windowUrl(WindowId wid)
@@ -694,11 +730,29 @@ bool XWindowInterface::isValidWindow(WindowId wid)
     return isAcceptableWindow(wid);
 }
 
+bool XWindowInterface::isValidWindow(WindowId wid, const XWindowData &data)
+{
+    if (windowsTracker()->isValidFor(wid)) {
+        return true;
+    }
+
+    return isAcceptableWindow(wid, data);
+}
+
 bool XWindowInterface::isAcceptableWindow(WindowId wid)
 {
-    const KWindowInfo info(wid.toUInt(), NET::WMGeometry | NET::WMState, NET::WM2WindowClass);
+    WId xwid = wid.value<WId>();
 
-    const auto winClass = QString(info.windowClassName());
+    if (m_prefetchedData.contains(xwid)) {
+        return isAcceptableWindow(wid, m_prefetchedData[xwid]);
+    }
+
+    return isAcceptableWindow(wid, m_dataFetcher.fetch(xwid));
+}
+
+bool XWindowInterface::isAcceptableWindow(WindowId wid, const XWindowData &info)
+{
+    const auto winClass = QString(info.windowClassName);
 
     //! ignored windows do not trackd
     if (hasBlockedTracking(wid)) {
@@ -720,16 +774,16 @@ bool XWindowInterface::isAcceptableWindow(WindowId wid)
                  || (winClass == QLatin1String("krunner"))) )) {
         registerWhitelistedWindow(wid);
     } else if (winClass == QLatin1String("plasmashell")) {
-        if (isSkipped && isSidepanel(info.geometry())) {
+        if (isSkipped && isSidepanel(info.geometry)) {
             registerWhitelistedWindow(wid);
             return true;
-        } else if (isPlasmaPanel(info.geometry()) || isFullScreenWindow(info.geometry())) {
+        } else if (isPlasmaPanel(info.geometry) || isFullScreenWindow(info.geometry)) {
             registerPlasmaIgnoredWindow(wid);
             return false;
         }
     } else if ((winClass == QLatin1String("latte-dock"))
                || (winClass == QLatin1String("ksmserver"))) {
-        if (isFullScreenWindow(info.geometry())) {
+        if (isFullScreenWindow(info.geometry)) {
             registerIgnoredWindow(wid);
             return false;
         }
@@ -750,6 +804,10 @@ void XWindowInterface::windowAddedProxy(WId wid)
 
 void XWindowInterface::windowChangedProxy(WId wid, NET::Properties prop1, NET::Properties2 prop2)
 {
+    //! any fetched data for this window are outdated from now on
+    m_dataFetcher.invalidate(wid, prop2);
+    m_prefetchedData.remove(wid);
+
     if (!isValidWindow(wid)) {
         return;
     }
@@ -25,6 +25,7 @@
 #include <config-latte.h>
 #include "abstractwindowinterface.h"
 #include "windowinfowrap.h"
+#include "xwindowdatafetcher.h"
 
 // Qt
 #include <QObject>
@@ -54,6 +55,7 @@ public:
     WindowId activeWindow() override;
     WindowInfoWrap requestInfo(WindowId wid) override;
     WindowInfoWrap requestInfoActive() override;
+    QList<WindowInfoWrap> requestInfos(const QList<WindowId> &wids) override;
 
     void skipTaskBar(const QDialog &dialog) override;
     void slideWindow(QWindow &view, Slide location) override;
@@ -86,17 +88,22 @@ public:
 
 private:
     bool isAcceptableWindow(WindowId wid);
+    bool isAcceptableWindow(WindowId wid, const XWindowData &data);
     bool isValidWindow(WindowId wid);
+    bool isValidWindow(WindowId wid, const XWindowData &data);
 
-#if KF5_VERSION_MINOR >= 65
-    QRect visibleGeometry(const WindowId &wid, const QRect &frameGeometry) const;
-#endif
+    WindowInfoWrap infoFromData(WindowId wid, const XWindowData &data);
 
     void windowAddedProxy(WId wid);
     void windowChangedProxy(WId wid, NET::Properties prop1, NET::Properties2 prop2);
 
     QUrl windowUrl(WindowId wid);
 
+private:
+    XWindowDataFetcher m_dataFetcher;
+
+    //! windows data fetched in batch and not consumed yet
+    QHash<WId, XWindowData> m_prefetchedData;
 };
 
 }
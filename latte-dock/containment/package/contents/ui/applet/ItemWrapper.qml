@@ -397,6 +397,7 @@ Item{
 
                 providesColors: indicators.info.needsIconColors && source != ""
                 usesPlasmaTheme: communicator.appletIconItemIsShown() ? communicator.appletIconItem.usesPlasmaTheme : false
+                usesMipmaps: appletItem.parabolic.factor.zoom > 1
 
                 Binding{
                     target: _overlayIconLoader
@@ -0,0 +1,266 @@
+/*
+ * Copyright 2020  Michail Vourlakos <mvourlakos@gmail.com>
+ *
+ * This file is part of Latte-Dock
+ *
+ * Latte-Dock is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Latte-Dock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "iconcache.h"
+
+// Qt
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+// KDE
+#include <KIconTheme>
+#include <KIconThemes/KIconLoader>
+
+#define DEFAULTMEMORYBUDGET 20480
+
+//! persistent icon colors, they are written lazily after changes
+#define COLORSFILE "lattedock/iconcolors"
+#define COLORSMAGIC 0x4C494343
+#define COLORSVERSION 2
+#define MAXCACHEDCOLORS 1024
+#define COLORSSAVEINTERVAL 5000
+
+namespace Latte {
+
+IconCache::IconCache(QObject *parent)
+    : QObject(parent),
+      m_colors(MAXCACHEDCOLORS)
+{
+    bool ok{false};
+    int budget = qEnvironmentVariableIntValue("LATTE_ICONCACHE_BUDGET", &ok);
+
+    setMemoryBudget(ok && budget > 0 ? budget : DEFAULTMEMORYBUDGET);
+
+    //! rasterized icons are invalid when the icon or plasma theme changes
+    connect(KIconLoader::global(), SIGNAL(iconLoaderSettingsChanged()), this, SLOT(clear()));
+    connect(KIconLoader::global(), SIGNAL(iconChanged(int)), this, SLOT(clear()));
+    connect(&m_theme, &Plasma::Theme::themeChanged, this, &IconCache::clear);
+
+    m_colorsFile = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QLatin1Char('/') + COLORSFILE;
+
+    m_colorsSaveTimer.setSingleShot(true);
+    m_colorsSaveTimer.setInterval(COLORSSAVEINTERVAL);
+    connect(&m_colorsSaveTimer, &QTimer::timeout, this, &IconCache::saveColors);
+
+    loadColors();
+
+    //! pixmaps must be released and colors must be stored while the application still exists
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &IconCache::onAboutToQuit);
+}
+
+IconCache *IconCache::self()
+{
+    //! owned by the application because it is also loaded from plasmashell
+    static QPointer<IconCache> cache;
+
+    if (!cache) {
+        cache = new IconCache(qApp);
+    }
+
+    return cache;
+}
+
+void IconCache::onAboutToQuit()
+{
+    if (m_colorsSaveTimer.isActive()) {
+        saveColors();
+    }
+
+    m_pixmaps.clear();
+}
+
+int IconCache::memoryBudget() const
+{
+    return m_pixmaps.maxCost();
+}
+
+void IconCache::setMemoryBudget(int kbytes)
+{
+    if (m_pixmaps.maxCost() == kbytes) {
+        return;
+    }
+
+    m_pixmaps.setMaxCost(kbytes);
+}
+
+bool IconCache::contains(const QString &key) const
+{
+    return m_pixmaps.contains(key);
+}
+
+QPixmap IconCache::pixmap(const QString &key) const
+{
+    QPixmap *cached = m_pixmaps.object(key);
+
+    return cached ? *cached : QPixmap();
+}
+
+void IconCache::insert(const QString &key, const QPixmap &pixmap)
+{
+    if (key.isEmpty() || pixmap.isNull()) {
+        return;
+    }
+
+    int cost = qMax(1, (pixmap.width() * pixmap.height() * pixmap.depth() / 8) / 1024);
+
+    m_pixmaps.insert(key, new QPixmap(pixmap), cost);
+}
+
+void IconCache::invalidate(const QString &sourceId)
+{
+    const QString prefix = sourceId + QLatin1Char('|');
+
+    for (const auto &key : m_pixmaps.keys()) {
+        if (key.startsWith(prefix)) {
+            m_pixmaps.remove(key);
+        }
+    }
+}
+
+void IconCache::clear()
+{
+    m_pixmaps.clear();
+}
+
+//! colors depend only on the icon source and the themes that are used to render it,
+//! sources without a name or path are valid only for the current session
+QString IconCache::colorsKey(const QString &sourceId) const
+{
+    if (sourceId.isEmpty()) {
+        return QString();
+    }
+
+    const auto *iconTheme = KIconLoader::global()->theme();
+
+    return sourceId + QLatin1Char('|') + (iconTheme ? iconTheme->internalName() : QString())
+            + QLatin1Char('|') + m_theme.themeName();
+}
+
+bool IconCache::colors(const QString &colorsKey, QColor &background, QColor &glow) const
+{
+    if (colorsKey.isEmpty() || !m_colors.contains(colorsKey)) {
+        return false;
+    }
+
+    const QPair<QColor, QColor> *colors = m_colors.object(colorsKey);
+    background = colors->first;
+    glow = colors->second;
+
+    return true;
+}
+
+void IconCache::insertColors(const QString &colorsKey, const QColor &background, const QColor &glow)
+{
+    if (colorsKey.isEmpty()) {
+        return;
+    }
+
+    m_colors.insert(colorsKey, new QPair<QColor, QColor>(background, glow));
+
+    if (!colorsKey.startsWith(QLatin1String("_icon_")) && !colorsKey.startsWith(QLatin1String("_image_"))) {
+        m_colorsSaveTimer.start();
+    }
+}
+
+//! Binary format: magic, version, entries count and for each entry:
+//! colors key, background rgba, glow rgba
+void IconCache::loadColors()
+{
+    QFile file(m_colorsFile);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_9);
+
+    quint32 magic; quint32 version; quint32 count;
+    in >> magic >> version >> count;
+
+    if (in.status() != QDataStream::Ok || magic != COLORSMAGIC || version != COLORSVERSION) {
+        return;
+    }
+
+    for (quint32 i=0; i<count; ++i) {
+        QString colorsKey;
+        quint32 background; quint32 glow;
+
+        in >> colorsKey >> background >> glow;
+
+        if (in.status() != QDataStream::Ok) {
+            m_colors.clear();
+            return;
+        }
+
+        m_colors.insert(colorsKey, new QPair<QColor, QColor>(QColor::fromRgba(background), QColor::fromRgba(glow)));
+    }
+}
+
+void IconCache::saveColors()
+{
+    m_colorsSaveTimer.stop();
+
+    QDir().mkpath(QFileInfo(m_colorsFile).absolutePath());
+
+    QSaveFile file(m_colorsFile);
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QStringList colorsKeys;
+
+    for (const auto &colorsKey : m_colors.keys()) {
+        if (!colorsKey.startsWith(QLatin1String("_icon_")) && !colorsKey.startsWith(QLatin1String("_image_"))) {
+            colorsKeys << colorsKey;
+        }
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_9);
+
+    out << (quint32)COLORSMAGIC << (quint32)COLORSVERSION << (quint32)colorsKeys.count();
+
+    for (const auto &colorsKey : colorsKeys) {
+        const QPair<QColor, QColor> *colors = m_colors.object(colorsKey);
+        out << colorsKey << (quint32)colors->first.rgba() << (quint32)colors->second.rgba();
+    }
+
+    file.commit();
+}
+
+QString IconCache::key(const QString &sourceId, int pixelSize, qreal devicePixelRatio, State state, const QStringList &overlays, int colorGroup)
+{
+    if (sourceId.isEmpty()) {
+        return QString();
+    }
+
+    return sourceId + QLatin1Char('|') + QString::number(pixelSize) + QLatin1Char('|') + QString::number(devicePixelRatio)
+            + QLatin1Char('|') + QString::number(state) + QLatin1Char('|') + QString::number(colorGroup)
+            + QLatin1Char('|') + overlays.join(QLatin1Char(','));
+}
+
+}
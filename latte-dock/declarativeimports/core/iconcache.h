@@ -0,0 +1,104 @@
+/*
+ * Copyright 2020  Michail Vourlakos <mvourlakos@gmail.com>
+ *
+ * This file is part of Latte-Dock
+ *
+ * Latte-Dock is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Latte-Dock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ICONCACHE_H
+#define ICONCACHE_H
+
+// Qt
+#include <QCache>
+#include <QColor>
+#include <QHash>
+#include <QObject>
+#include <QPixmap>
+#include <QPointer>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+// Plasma
+#include <Plasma/Theme>
+
+namespace Latte {
+
+//! Process-wide cache of the final icon pixmaps that IconItems paint. Icons with the
+//! same source, size, device pixel ratio, state and overlays are rasterized only once
+//! and shared between all docks and panels. Least recently used pixmaps are evicted
+//! when the memory budget is exceeded. The budget is measured in KB and can be set
+//! through LATTE_ICONCACHE_BUDGET environment variable.
+//! It also caches the background and glow colors of icons. Colors of icons that are
+//! identified by name or path are persisted in order to be reused between sessions.
+class IconCache final: public QObject
+{
+    Q_OBJECT
+
+public:
+    enum State {
+        NormalState = 0,
+        ActiveState,
+        DisabledState
+    };
+
+    static IconCache *self();
+
+    int memoryBudget() const;
+    void setMemoryBudget(int kbytes);
+
+    bool contains(const QString &key) const;
+    QPixmap pixmap(const QString &key) const;
+    void insert(const QString &key, const QPixmap &pixmap);
+
+    //! remove all pixmaps that were rasterized from the provided source
+    void invalidate(const QString &sourceId);
+
+    //! colors
+    QString colorsKey(const QString &sourceId) const;
+    bool colors(const QString &colorsKey, QColor &background, QColor &glow) const;
+    void insertColors(const QString &colorsKey, const QColor &background, const QColor &glow);
+
+    //! pixelSize is the rendered size in device pixels, 0 for pixmaps that do not depend on it
+    static QString key(const QString &sourceId, int pixelSize, qreal devicePixelRatio, State state, const QStringList &overlays, int colorGroup);
+
+public slots:
+    void clear();
+
+private slots:
+    void onAboutToQuit();
+    void saveColors();
+
+private:
+    IconCache(QObject *parent = nullptr);
+
+    void loadColors();
+
+private:
+    QString m_colorsFile;
+
+    QCache<QString, QPixmap> m_pixmaps;
+
+    //! colors key -> background and glow colors, least recently used are evicted first
+    QCache<QString, QPair<QColor, QColor>> m_colors;
+    QTimer m_colorsSaveTimer;
+
+    Plasma::Theme m_theme;
+};
+
+}
+
+#endif
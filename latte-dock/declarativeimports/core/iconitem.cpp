@@ -24,9 +24,13 @@
 
 // local
 #include "extras.h"
+#include "iconcache.h"
 
 // Qt
+#include <QDateTime>
 #include <QDebug>
+#include <QDir>
+#include <QFileInfo>
 #include <QPainter>
 #include <QPaintEngine>
 #include <QQuickWindow>
@@ -39,6 +43,15 @@
 #include <KIconThemes/KIconLoader>
 #include <KIconThemes/KIconEffect>
 
+//! maximum icon size that is sampled in order to compute its colors
+#define COLORSSAMPLINGSIZE 64
+
+//! mipmaps are power of two size buckets, they are pre-rendered for sizes
+//! up to MIPMAPZOOMRANGE times the icon size when continuous resizing starts
+#define MIPMAPMINSIZE 16
+#define MIPMAPZOOMRANGE 2
+#define MIPMAPSETTLEINTERVAL 200
+
 namespace Latte {
 
 IconItem::IconItem(QQuickItem *parent)
@@ -69,6 +82,10 @@ IconItem::IconItem(QQuickItem *parent)
     setImplicitWidth(KIconLoader::global()->currentSize(KIconLoader::Dialog));
     setImplicitHeight(KIconLoader::global()->currentSize(KIconLoader::Dialog));
     setSmooth(true);
+
+    m_mipmapsSettleTimer.setSingleShot(true);
+    m_mipmapsSettleTimer.setInterval(MIPMAPSETTLEINTERVAL);
+    connect(&m_mipmapsSettleTimer, &QTimer::timeout, this, &IconItem::mipmapsSettled);
 }
 
 IconItem::~IconItem()
@@ -99,6 +116,9 @@ void IconItem::setSource(const QVariant &source)
         if (url.isLocalFile()) {
             m_icon = QIcon();
             m_imageIcon = QImage(url.path());
+            //! the modification time invalidates pixmaps of files that are changed in place
+            m_sourceCacheId = QLatin1String("_file_") + url.path() + QLatin1Char('@')
+                    + QString::number(QFileInfo(url.path()).lastModified().toMSecsSinceEpoch());
             m_svgIconName.clear();
             m_svgIcon.reset();
         } else {
@@ -108,7 +128,7 @@ void IconItem::setSource(const QVariant &source)
                 m_svgIcon->setStatus(Plasma::Svg::Normal);
                 m_svgIcon->setUsingRenderingCache(false);
                 m_svgIcon->setDevicePixelRatio((window() ? window()->devicePixelRatio() : qApp->devicePixelRatio()));
-                connect(m_svgIcon.get(), &Plasma::Svg::repaintNeeded, this, &IconItem::schedulePixmapUpdate);
+                connect(m_svgIcon.get(), &Plasma::Svg::repaintNeeded, this, &IconItem::svgRepaintNeeded);
             }
 
             if (m_usesPlasmaTheme) {
@@ -156,6 +176,10 @@ void IconItem::setSource(const QVariant &source)
                         m_icon = QIcon::fromTheme(sourceString);
                     }
 
+                    //! icons with a name are loaded from the icon theme and can be shared
+                    m_sourceCacheId = !m_icon.name().isEmpty() ? QLatin1String("_theme_") + m_icon.name()
+                                                               : QLatin1String("_icon_") + QString::number(m_icon.cacheKey());
+
                     m_svgIconName.clear();
                     m_svgIcon.reset();
                     m_imageIcon = QImage();
@@ -166,6 +190,7 @@ void IconItem::setSource(const QVariant &source)
         m_icon = source.value<QIcon>();
         m_iconCounter++;
         setLastLoadedSourceId("_icon_"+QString::number(m_iconCounter));
+        m_sourceCacheId = QLatin1String("_icon_") + QString::number(m_icon.cacheKey());
 
         m_imageIcon = QImage();
         m_svgIconName.clear();
@@ -174,6 +199,7 @@ void IconItem::setSource(const QVariant &source)
         m_imageIcon = source.value<QImage>();
         m_iconCounter++;
         setLastLoadedSourceId("_image_"+QString::number(m_iconCounter));
+        m_sourceCacheId = QLatin1String("_image_") + QString::number(m_imageIcon.cacheKey());
 
         m_icon = QIcon();
         m_svgIconName.clear();
@@ -183,6 +209,7 @@ void IconItem::setSource(const QVariant &source)
         m_imageIcon = QImage();
         m_svgIconName.clear();
         m_svgIcon.reset();
+        m_sourceCacheId.clear();
     }
 
     if (width() > 0 && height() > 0) {
@@ -310,6 +337,27 @@ bool IconItem::smooth() const
     return m_smooth;
 }
 
+bool IconItem::usesMipmaps() const
+{
+    return m_usesMipmaps;
+}
+
+void IconItem::setUsesMipmaps(bool usesMipmaps)
+{
+    if (m_usesMipmaps == usesMipmaps) {
+        return;
+    }
+
+    m_usesMipmaps = usesMipmaps;
+
+    if (!m_usesMipmaps && m_mipmapsActive) {
+        m_mipmapsSettleTimer.stop();
+        mipmapsSettled();
+    }
+
+    emit usesMipmapsChanged();
+}
+
 bool IconItem::isValid() const
 {
     return !m_icon.isNull() || m_svgIcon || !m_imageIcon.isNull();
@@ -370,7 +418,8 @@ QSGNode *IconItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *update
 
         textureNode = new ManagedTextureNode;
         textureNode->setTexture(QSharedPointer<QSGTexture>(window()->createTextureFromImage(m_iconPixmap.toImage(), QQuickWindow::TextureCanUseAtlas)));
-        textureNode->setFiltering(smooth() ? QSGTexture::Linear : QSGTexture::Nearest);
+        //! mipmaps are always scaled to the item size
+        textureNode->setFiltering(smooth() || m_mipmapsActive ? QSGTexture::Linear : QSGTexture::Nearest);
 
         m_sizeChanged = true;
         m_textureChanged = false;
@@ -388,14 +437,64 @@ QSGNode *IconItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *update
 
 void IconItem::schedulePixmapUpdate()
 {
+    //! any change other than the item size invalidates the pre-rendered mipmaps
+    m_mipmaps.clear();
+    m_currentMipmap = 0;
+
+    polish();
+}
+
+void IconItem::mipmapsSettled()
+{
+    m_mipmapsActive = false;
+    m_mipmaps.clear();
+    m_currentMipmap = 0;
+
     polish();
 }
 
+int IconItem::mipmapBucket(qreal size) const
+{
+    int bucket{MIPMAPMINSIZE};
+
+    while (bucket < size) {
+        bucket *= 2;
+    }
+
+    return bucket;
+}
+
+void IconItem::prerenderMipmaps(qreal size)
+{
+    const int maxBucket = mipmapBucket(size * MIPMAPZOOMRANGE);
+
+    for (int bucket = mipmapBucket(size); bucket <= maxBucket; bucket *= 2) {
+        if (!m_mipmaps.contains(bucket)) {
+            m_mipmaps[bucket] = renderPixmap(bucket);
+        }
+    }
+}
+
 void IconItem::enabledChanged()
 {
     schedulePixmapUpdate();
 }
 
+void IconItem::svgRepaintNeeded()
+{
+    IconCache::self()->invalidate(svgCacheId());
+    schedulePixmapUpdate();
+}
+
+QString IconItem::svgCacheId() const
+{
+    if (!m_svgIcon) {
+        return QString();
+    }
+
+    return QLatin1String("_svg_") + m_svgIcon->imagePath() + QLatin1Char('#') + m_svgIconName;
+}
+
 QColor IconItem::backgroundColor() const
 {
     return m_backgroundColor;
@@ -426,39 +525,107 @@ void IconItem::setGlowColor(QColor glow)
     emit glowColorChanged();
 }
 
+//! cached colors of icons that are loaded from files are valid only for the
+//! file modification time they were computed for
+QString IconItem::colorsSourceId() const
+{
+    const QString sourceId = m_svgIcon ? svgCacheId() : m_sourceCacheId;
+
+    if (sourceId.isEmpty()) {
+        return QString();
+    }
+
+    QString iconFile;
+
+    if (m_svgIcon && QDir::isAbsolutePath(m_svgIcon->imagePath())) {
+        iconFile = m_svgIcon->imagePath();
+    } else if (!m_svgIcon && !m_icon.isNull() && !m_icon.name().isEmpty()) {
+        iconFile = KIconLoader::global()->iconPath(m_icon.name(), KIconLoader::Desktop, true);
+    }
+
+    QFileInfo info(iconFile);
+
+    if (iconFile.isEmpty() || !info.exists()) {
+        return sourceId;
+    }
+
+    return sourceId + QLatin1Char('@') + QString::number(info.lastModified().toMSecsSinceEpoch());
+}
+
+//! colors are computed from the source itself and not from the painted pixmap, which
+//! can contain overlays, state effects and a different color group
+QImage IconItem::colorsSamplingImage() const
+{
+    if (m_svgIcon) {
+        Plasma::Svg svg;
+        svg.setImagePath(m_svgIcon->imagePath());
+        svg.setContainsMultipleImages(m_svgIcon->containsMultipleImages());
+        svg.resize(COLORSSAMPLINGSIZE, COLORSSAMPLINGSIZE);
+
+        return (svg.hasElement(m_svgIconName) ? svg.pixmap(m_svgIconName) : svg.pixmap()).toImage();
+    } else if (!m_icon.isNull()) {
+        return m_icon.pixmap(QSize(COLORSSAMPLINGSIZE, COLORSSAMPLINGSIZE)).toImage();
+    }
+
+    return m_imageIcon;
+}
+
 void IconItem::updateColors()
 {
-    QImage icon = m_iconPixmap.toImage();
+    const QString colorsKey = IconCache::self()->colorsKey(colorsSourceId());
+
+    QColor background;
+    QColor glow;
+
+    if (IconCache::self()->colors(colorsKey, background, glow)) {
+        setBackgroundColor(background);
+        setGlowColor(glow);
+        return;
+    }
+
+    QImage icon = colorsSamplingImage();
 
     if (icon.format() != QImage::Format_Invalid) {
-        float rtotal = 0, gtotal = 0, btotal = 0;
-        float total = 0.0f;
+        //! colors are averaged, a downsampled icon provides almost the same result much faster
+        if (icon.width() > COLORSSAMPLINGSIZE || icon.height() > COLORSSAMPLINGSIZE) {
+            icon = icon.scaled(COLORSSAMPLINGSIZE, COLORSSAMPLINGSIZE, Qt::KeepAspectRatio, Qt::FastTransformation);
+        }
+
+        icon = icon.convertToFormat(QImage::Format_ARGB32);
+
+        //! pixel relevance is 0.1 + 0.9 * alpha * saturation, it is multiplied
+        //! by 10*255*255 in order to be accumulated with integers only
+        quint64 rtotal{0}, gtotal{0}, btotal{0};
+        quint64 total{0};
 
         for(int row=0; row<icon.height(); ++row) {
-            QRgb *line = (QRgb *)icon.scanLine(row);
+            const QRgb *line = reinterpret_cast<const QRgb *>(icon.constScanLine(row));
 
             for(int col=0; col<icon.width(); ++col) {
-                QRgb pix = line[col];
+                const QRgb pix = line[col];
 
-                int r = qRed(pix);
-                int g = qGreen(pix);
-                int b = qBlue(pix);
-                int a = qAlpha(pix);
+                const int r = qRed(pix);
+                const int g = qGreen(pix);
+                const int b = qBlue(pix);
+                const int a = qAlpha(pix);
 
-                float saturation = (qMax(r, qMax(g, b)) - qMin(r, qMin(g, b))) / 255.0f;
-                float relevance = .1 + .9 * (a / 255.0f) * saturation;
+                const quint64 relevance = 65025 + 9 * a * (qMax(r, qMax(g, b)) - qMin(r, qMin(g, b)));
 
-                rtotal += (float)(r * relevance);
-                gtotal += (float)(g * relevance);
-                btotal += (float)(b * relevance);
+                rtotal += r * relevance;
+                gtotal += g * relevance;
+                btotal += b * relevance;
 
-                total += relevance * 255;
+                total += relevance;
             }
         }
 
-        int nr = (rtotal / total) * 255;
-        int ng = (gtotal / total) * 255;
-        int nb = (btotal / total) * 255;
+        if (total == 0) {
+            return;
+        }
+
+        int nr = rtotal / total;
+        int ng = gtotal / total;
+        int nb = btotal / total;
 
         QColor tempColor(nr, ng, nb);
 
@@ -468,29 +635,45 @@ void IconItem::updateColors()
 
         tempColor.setHsvF(tempColor.hueF(), tempColor.saturationF(), 0.55f); //original 0.90f ???
 
-        setBackgroundColor(tempColor);
+        background = tempColor;
 
         tempColor.setHsvF(tempColor.hueF(), tempColor.saturationF(), 1.0f);
 
-        setGlowColor(tempColor);
+        glow = tempColor;
+
+        IconCache::self()->insertColors(colorsKey, background, glow);
+
+        setBackgroundColor(background);
+        setGlowColor(glow);
     }
 }
 
-void IconItem::loadPixmap()
+QPixmap IconItem::renderPixmap(qreal size)
 {
-    if (!isComponentComplete()) {
-        return;
-    }
-
-    const auto size = qMin(width(), height());
     //final pixmap to paint
     QPixmap result;
 
-    if (size <= 0) {
-        m_iconPixmap = QPixmap();
-        update();
-        return;
-    } else if (m_svgIcon) {
+    //! identical icons are rasterized only once for all items
+    const qreal devicePixelRatio = window() ? window()->devicePixelRatio() : qApp->devicePixelRatio();
+    const IconCache::State state = !isEnabled() ? IconCache::DisabledState : (m_active ? IconCache::ActiveState : IconCache::NormalState);
+
+    //! the key uses the integer size in device pixels that is really rendered,
+    //! images are painted from their full size so their size is not part of the key
+    int pixelSize{0};
+
+    if (m_svgIcon) {
+        pixelSize = qRound(qRound(size) * m_svgIcon->devicePixelRatio());
+    } else if (!m_icon.isNull()) {
+        pixelSize = (QSize(static_cast<int>(size), static_cast<int>(size)) * devicePixelRatio).width();
+    }
+
+    const QString cacheKey = IconCache::key(m_svgIcon ? svgCacheId() : m_sourceCacheId, pixelSize, devicePixelRatio, state, m_overlays, m_colorGroup);
+
+    if (!cacheKey.isEmpty() && IconCache::self()->contains(cacheKey)) {
+        return IconCache::self()->pixmap(cacheKey);
+    }
+
+    if (m_svgIcon) {
         m_svgIcon->resize(size, size);
 
         if (m_svgIcon->hasElement(m_svgIconName)) {
@@ -501,12 +684,12 @@ void IconItem::loadPixmap()
 
             if (iconTheme) {
                 iconPath = iconTheme->iconPath(m_svgIconName + QLatin1String(".svg")
-                                               , static_cast<int>(qMin(width(), height()))
+                                               , static_cast<int>(size)
                                                , KIconLoader::MatchBest);
 
                 if (iconPath.isEmpty()) {
                     iconPath = iconTheme->iconPath(m_svgIconName + QLatin1String(".svgz"),
-                                                   static_cast<int>(qMin(width(), height()))
+                                                   static_cast<int>(size)
                                                    , KIconLoader::MatchBest);
                 }
             } else {
@@ -520,14 +703,11 @@ void IconItem::loadPixmap()
             result = m_svgIcon->pixmap();
         }
     } else if (!m_icon.isNull()) {
-        result = m_icon.pixmap(QSize(static_cast<int>(size), static_cast<int>(size))
-                               * (window() ? window()->devicePixelRatio() : qApp->devicePixelRatio()));
+        result = m_icon.pixmap(QSize(static_cast<int>(size), static_cast<int>(size)) * devicePixelRatio);
     } else if (!m_imageIcon.isNull()) {
         result = QPixmap::fromImage(m_imageIcon);
     } else {
-        m_iconPixmap = QPixmap();
-        update();
-        return;
+        return QPixmap();
     }
 
     // Strangely KFileItem::overlays() returns empty string-values, so
@@ -550,6 +730,52 @@ void IconItem::loadPixmap()
         result = KIconLoader::global()->iconEffect()->apply(result, KIconLoader::Desktop, KIconLoader::ActiveState);
     }
 
+    IconCache::self()->insert(cacheKey, result);
+
+    return result;
+}
+
+void IconItem::loadPixmap()
+{
+    if (!isComponentComplete()) {
+        return;
+    }
+
+    const auto size = qMin(width(), height());
+    //final pixmap to paint
+    QPixmap result;
+
+    if (size <= 0) {
+        m_iconPixmap = QPixmap();
+        update();
+        return;
+    }
+
+    if (m_mipmapsActive) {
+        //! while resizing continuously the nearest larger mipmap is scaled by the scene graph
+        const int bucket = mipmapBucket(size);
+
+        if (bucket == m_currentMipmap && !m_iconPixmap.isNull()) {
+            update();
+            return;
+        }
+
+        if (!m_mipmaps.contains(bucket)) {
+            m_mipmaps[bucket] = renderPixmap(bucket);
+        }
+
+        result = m_mipmaps[bucket];
+        m_currentMipmap = bucket;
+    } else {
+        result = renderPixmap(size);
+    }
+
+    if (result.isNull()) {
+        m_iconPixmap = QPixmap();
+        update();
+        return;
+    }
+
     m_iconPixmap = result;
 
     if (m_providesColors && m_lastLoadedSourceId != m_lastColorsSourceId) {
@@ -573,7 +799,18 @@ void IconItem::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeome
         m_sizeChanged = true;
 
         if (newGeometry.width() > 1 && newGeometry.height() > 1) {
-            schedulePixmapUpdate();
+            if (m_usesMipmaps && !m_iconPixmap.isNull()) {
+                //! the crisp pixmap is rendered only when the size settles
+                if (!m_mipmapsActive) {
+                    m_mipmapsActive = true;
+                    prerenderMipmaps(qMin(oldGeometry.width(), oldGeometry.height()));
+                }
+
+                m_mipmapsSettleTimer.start();
+                polish();
+            } else {
+                schedulePixmapUpdate();
+            }
         } else {
             update();
         }
@@ -30,7 +30,9 @@
 #include <QQuickItem>
 #include <QIcon>
 #include <QImage>
+#include <QMap>
 #include <QPixmap>
+#include <QTimer>
 
 // Plasma
 #include <Plasma/Svg>
@@ -98,6 +100,13 @@ class IconItem : public QQuickItem
      */
     Q_PROPERTY(bool usesPlasmaTheme READ usesPlasmaTheme WRITE setUsesPlasmaTheme NOTIFY usesPlasmaThemeChanged)
 
+    /**
+     * If set, while the icon is resized continuously e.g. during parabolic zoom,
+     * pre-rendered power of two size buckets are scaled instead of rendering the icon
+     * for every size. The icon is rendered for its exact size when resizing settles.
+     */
+    Q_PROPERTY(bool usesMipmaps READ usesMipmaps WRITE setUsesMipmaps NOTIFY usesMipmapsChanged)
+
     /**
      * If set, icon will provide a background and glow color
      */
@@ -137,6 +146,9 @@ public:
     bool usesPlasmaTheme() const;
     void setUsesPlasmaTheme(bool usesPlasmaTheme);
 
+    bool usesMipmaps() const;
+    void setUsesMipmaps(bool usesMipmaps);
+
     int paintedWidth() const;
     int paintedHeight() const;
 
@@ -165,21 +177,32 @@ signals:
     void providesColorsChanged();
     void smoothChanged();
     void sourceChanged();
+    void usesMipmapsChanged();
     void usesPlasmaThemeChanged();
     void validChanged();
 
 private slots:
     void schedulePixmapUpdate();
     void enabledChanged();
+    void svgRepaintNeeded();
+    void mipmapsSettled();
 
 private:
     void loadPixmap();
+    void prerenderMipmaps(qreal size);
     void updateColors();
     void setLastLoadedSourceId(QString id);
     void setLastValidSourceName(QString name);
     void setBackgroundColor(QColor background);
     void setGlowColor(QColor glow);
 
+    int mipmapBucket(qreal size) const;
+
+    QString colorsSourceId() const;
+    QString svgCacheId() const;
+    QImage colorsSamplingImage() const;
+    QPixmap renderPixmap(qreal size);
+
 private:
     bool m_active;
     bool m_providesColors{false};
@@ -190,6 +213,10 @@ private:
     bool m_sizeChanged;
     bool m_usesPlasmaTheme;
 
+    bool m_usesMipmaps{false};
+    bool m_mipmapsActive{false};
+    int m_currentMipmap{0};
+
     QColor m_backgroundColor;
     QColor m_glowColor;
 
@@ -199,6 +226,9 @@ private:
     std::unique_ptr<Plasma::Svg> m_svgIcon;
     QString m_svgIconName;
 
+    //! identifies the icon source in the shared IconCache, svg icons use svgCacheId() instead
+    QString m_sourceCacheId;
+
     //! can be used to track changes during source "changes" independent
     //! of the source type
     int m_iconCounter{0};
@@ -222,6 +252,10 @@ private:
     QVariant m_source;
 
     QSizeF m_implicitSize;
+
+    //! pre-rendered pixmaps per size bucket
+    QMap<int, QPixmap> m_mipmaps;
+    QTimer m_mipmapsSettleTimer;
 };
 
 }
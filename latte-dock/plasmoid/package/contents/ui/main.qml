@@ -276,6 +276,11 @@ Item {
             plasmoid.action("configure").visible = false;
             plasmoid.configuration.isInLatteDock = true;
 
+            if (latteView.layoutsManager) {
+                //! receive launchers changes from other latte tasks plasmoids
+                latteView.layoutsManager.launchersSignals.registerTasks(plasmoid.id, root);
+            }
+
             if (root.launchersGroup === LatteCore.Types.LayoutLaunchers
                     || root.launchersGroup === LatteCore.Types.GlobalLaunchers) {
                 tasksModel.updateLaunchersList();
@@ -1862,6 +1867,10 @@ Item {
     }
 
     Component.onDestruction: {
+        if (latteView && latteView.layoutsManager) {
+            latteView.layoutsManager.launchersSignals.unregisterTasks(plasmoid.id);
+        }
+
         root.presentWindows.disconnect(backend.presentWindows);
         root.windowsHovered.disconnect(backend.windowsHovered);
         dragHelper.dropped.disconnect(resetDragSource);
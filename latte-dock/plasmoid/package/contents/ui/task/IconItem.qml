@@ -161,6 +161,7 @@ Item{
             source: decoration
             smooth: taskItem.parabolic.factor.zoom === 1 ? true : false
             providesColors: indicators ? indicators.info.needsIconColors : false
+            usesMipmaps: taskItem.parabolic.factor.zoom > 1
 
             opacity: root.enableShadows
                      && taskWithShadow.active